@@ -0,0 +1,521 @@
+/**
+ * @file bigdecimal.hpp
+ * @author {Eva Wu} ({gudautd@gmail.com})
+ * @brief Header file and implementation of arbitrary precision fixed-point decimal class 'bigdecimal'
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include "bigint.hpp"
+
+/** @brief How a result is rounded when digits beyond its scale are dropped. */
+enum class rounding_mode
+{
+    down,      ///< Toward zero (truncate).
+    up,        ///< Away from zero.
+    floor,     ///< Toward negative infinity.
+    ceiling,   ///< Toward positive infinity.
+    half_up,   ///< To nearest, ties away from zero.
+    half_down, ///< To nearest, ties toward zero.
+    half_even  ///< To nearest, ties to the even neighbour (banker's rounding).
+};
+
+/**
+ * @brief Class representing an exact decimal number coefficient * 10^(-scale).
+ * Since bigint stores base 10 digits, aligning or rescaling by a power of ten is a single digit shift.
+ */
+class bigdecimal
+{
+private:
+    /** @brief Unscaled value. */
+    bigint coefficient;
+
+    /** @brief Number of digits after the decimal point, may be negative. */
+    int32_t scale = 0;
+
+    /** @brief Exception for a scale outside the int32_t range. */
+    inline static std::overflow_error scale_overflow = std::overflow_error("Scale does not fit in int32_t!");
+
+    /** @brief Exception for a string that is not a decimal number. */
+    inline static invalid_argument invalid_initializing_string = invalid_argument("Initializing string should be digits with an optional sign and decimal point!");
+
+    /** @brief Exception for a string whose integer part starts with zero. */
+    inline static invalid_argument zero_initializing_string = invalid_argument("Initializing string should not start with zero!");
+
+    /** @brief Checks that a computed scale fits in int32_t.
+     *  @param new_scale The computed scale.
+     *  @return The scale as int32_t.
+     */
+    static int32_t checkedScale(int64_t new_scale);
+
+    /** @brief Brings two decimals to the larger of their scales by shifting the coefficient of the other.
+     *  @param lhs The first decimal, rescaled in place.
+     *  @param rhs The second decimal, copied and rescaled if needed.
+     *  @return The coefficient of rhs at the common scale.
+     */
+    static bigint align(bigdecimal &lhs, const bigdecimal &rhs);
+
+    /** @brief Applies a rounding mode to a truncated quotient.
+     *  @param quotient The quotient truncated toward zero.
+     *  @param rem The remainder of the division, with the sign of the numerator.
+     *  @param den The denominator.
+     *  @param mode The rounding mode.
+     *  @return The rounded quotient.
+     */
+    static bigint round(bigint quotient, const bigint &rem, const bigint &den, rounding_mode mode);
+
+public:
+    /** @brief Constructs a bigdecimal initialized to zero with scale 0. */
+    bigdecimal();
+
+    /** @brief Constructs a bigdecimal from a coefficient and a scale.
+     *  @param new_coefficient The unscaled value.
+     *  @param new_scale The scale, the value is new_coefficient * 10^(-new_scale).
+     */
+    bigdecimal(const bigint &new_coefficient, int32_t new_scale = 0);
+
+    /** @brief Constructs a bigdecimal from an int64_t with scale 0.
+     *  @param number The int64_t value to initialize from.
+     */
+    bigdecimal(int64_t number);
+
+    /** @brief Constructs a bigdecimal from a string such as "-12.3400". The scale is the number of fraction digits.
+     *  @param str The string to initialize from.
+     */
+    bigdecimal(const string &str);
+
+    /** @brief Gets the unscaled value.
+     *  @return The coefficient.
+     */
+    const bigint &getCoefficient() const;
+
+    /** @brief Gets the scale.
+     *  @return The scale.
+     */
+    int32_t getScale() const;
+
+    /** @brief Returns the value at another scale, rounding if digits are dropped.
+     *  @param new_scale The scale of the result.
+     *  @param mode The rounding mode used when new_scale is smaller than the current scale.
+     *  @return The rescaled bigdecimal.
+     */
+    bigdecimal rescale(int32_t new_scale, rounding_mode mode = rounding_mode::half_even) const;
+
+    /** @brief Adds a bigdecimal; the result has the larger of the two scales.
+     *  @param rhs The bigdecimal to add.
+     *  @return Reference to the current bigdecimal after addition.
+     */
+    bigdecimal &operator+=(const bigdecimal &rhs);
+
+    /** @brief Subtracts a bigdecimal; the result has the larger of the two scales.
+     *  @param rhs The bigdecimal to subtract.
+     *  @return Reference to the current bigdecimal after subtraction.
+     */
+    bigdecimal &operator-=(const bigdecimal &rhs);
+
+    /** @brief Multiplies by a bigdecimal; the result scale is the sum of the two scales.
+     *  @param rhs The bigdecimal to multiply with.
+     *  @return Reference to the current bigdecimal after multiplication.
+     */
+    bigdecimal &operator*=(const bigdecimal &rhs);
+
+    /** @brief Negates the current bigdecimal. */
+    void negate();
+
+    /** @brief Rounds the exact quotient num / den to an integer.
+     *  @param num The numerator.
+     *  @param den The denominator, must not be zero.
+     *  @param mode The rounding mode.
+     *  @return The rounded quotient.
+     */
+    static bigint roundedQuotient(bigint num, const bigint &den, rounding_mode mode);
+};
+
+/**
+ * @brief Divides one bigdecimal by another.
+ * @param lhs The dividend.
+ * @param rhs The divisor, must not be zero.
+ * @param scale The scale of the result.
+ * @param mode The rounding mode applied to the digits beyond scale.
+ * @return The quotient of lhs and rhs at the given scale.
+ */
+bigdecimal divide(const bigdecimal &lhs, const bigdecimal &rhs, int32_t scale, rounding_mode mode = rounding_mode::half_even);
+
+/**
+ * @brief Negates a bigdecimal.
+ * @param opr The bigdecimal to negate.
+ * @return The negated bigdecimal.
+ */
+bigdecimal operator-(const bigdecimal &opr);
+
+/**
+ * @brief Adds two bigdecimal numbers.
+ * @param lhs The left-hand side bigdecimal.
+ * @param rhs The right-hand side bigdecimal.
+ * @return The sum of lhs and rhs.
+ */
+bigdecimal operator+(bigdecimal lhs, const bigdecimal &rhs);
+
+/**
+ * @brief Subtracts one bigdecimal from another.
+ * @param lhs The left-hand side bigdecimal.
+ * @param rhs The right-hand side bigdecimal to subtract from lhs.
+ * @return The difference of lhs and rhs.
+ */
+bigdecimal operator-(bigdecimal lhs, const bigdecimal &rhs);
+
+/**
+ * @brief Multiplies two bigdecimal numbers.
+ * @param lhs The left-hand side bigdecimal.
+ * @param rhs The right-hand side bigdecimal.
+ * @return The product of lhs and rhs.
+ */
+bigdecimal operator*(bigdecimal lhs, const bigdecimal &rhs);
+
+/**
+ * @brief Compares the values of two bigdecimal numbers, so 1.5 equals 1.50.
+ * @param lhs The left-hand side bigdecimal.
+ * @param rhs The right-hand side bigdecimal.
+ * @return True if lhs is equal to rhs, false otherwise.
+ */
+bool operator==(const bigdecimal &lhs, const bigdecimal &rhs);
+
+/**
+ * @brief Compares the values of two bigdecimal numbers for inequality.
+ * @param lhs The left-hand side bigdecimal.
+ * @param rhs The right-hand side bigdecimal.
+ * @return True if lhs is not equal to rhs, false otherwise.
+ */
+bool operator!=(const bigdecimal &lhs, const bigdecimal &rhs);
+
+/**
+ * @brief Checks if one bigdecimal is less than another.
+ * @param lhs The left-hand side bigdecimal.
+ * @param rhs The right-hand side bigdecimal.
+ * @return True if lhs is less than rhs, false otherwise.
+ */
+bool operator<(const bigdecimal &lhs, const bigdecimal &rhs);
+
+/**
+ * @brief Checks if one bigdecimal is less than or equal to another.
+ * @param lhs The left-hand side bigdecimal.
+ * @param rhs The right-hand side bigdecimal.
+ * @return True if lhs is less than or equal to rhs, false otherwise.
+ */
+bool operator<=(const bigdecimal &lhs, const bigdecimal &rhs);
+
+/**
+ * @brief Checks if one bigdecimal is greater than another.
+ * @param lhs The left-hand side bigdecimal.
+ * @param rhs The right-hand side bigdecimal.
+ * @return True if lhs is greater than rhs, false otherwise.
+ */
+bool operator>(const bigdecimal &lhs, const bigdecimal &rhs);
+
+/**
+ * @brief Checks if one bigdecimal is greater than or equal to another.
+ * @param lhs The left-hand side bigdecimal.
+ * @param rhs The right-hand side bigdecimal.
+ * @return True if lhs is greater than or equal to rhs, false otherwise.
+ */
+bool operator>=(const bigdecimal &lhs, const bigdecimal &rhs);
+
+/**
+ * @brief Converts a bigdecimal to a string with exactly scale digits after the decimal point.
+ * @param opr The bigdecimal to be converted.
+ * @return The string representation, such as "-0.050".
+ */
+string to_string(const bigdecimal &opr);
+
+/**
+ * @brief Overload the ostream operator for bigdecimal.
+ * @param out The output stream.
+ * @param opr The bigdecimal to be streamed.
+ * @return The updated output stream containing the bigdecimal representation.
+ */
+ostream &operator<<(ostream &out, const bigdecimal &opr);
+
+
+/** implementation starts **/
+
+
+bigdecimal::bigdecimal() {}
+
+
+bigdecimal::bigdecimal(const bigint &new_coefficient, int32_t new_scale) : coefficient(new_coefficient), scale(new_scale) {}
+
+
+bigdecimal::bigdecimal(int64_t number) : coefficient(number) {}
+
+
+bigdecimal::bigdecimal(const string &str)
+{
+    // An optional sign, an integer part following the bigint rules, then optionally '.' and the fraction digits
+    size_t i = (!str.empty() && str[0] == '-') ? 1 : 0;
+    size_t point = str.find('.');
+    size_t int_end = (point == string::npos) ? str.size() : point;
+    if (int_end == i || (point != string::npos && point + 1 == str.size()))
+        throw invalid_initializing_string;
+    if (str[i] == '0' && int_end - i > 1)
+        throw zero_initializing_string;
+    string digits_str = str.substr(i, int_end - i);
+    if (point != string::npos)
+    {
+        digits_str += str.substr(point + 1);
+        scale = checkedScale(int64_t(str.size() - point - 1));
+    }
+    for (char ch : digits_str)
+        if (ch < '0' || ch > '9')
+            throw invalid_initializing_string;
+
+    // Drop the leading zeros of the joined digits and reuse the bigint string constructor
+    size_t first = digits_str.find_first_not_of('0');
+    digits_str.erase(0, std::min(first, digits_str.size() - 1));
+    coefficient = bigint(digits_str);
+    if (i)
+        coefficient.negate();
+}
+
+
+const bigint &bigdecimal::getCoefficient() const
+{
+    return coefficient;
+}
+
+
+int32_t bigdecimal::getScale() const
+{
+    return scale;
+}
+
+
+int32_t bigdecimal::checkedScale(int64_t new_scale)
+{
+    if (new_scale < std::numeric_limits<int32_t>::min() || new_scale > std::numeric_limits<int32_t>::max())
+        throw scale_overflow;
+    return int32_t(new_scale);
+}
+
+
+bigint bigdecimal::roundedQuotient(bigint num, const bigint &den, rounding_mode mode)
+{
+    bigint rem = num.divmod(den);
+    return round(num, rem, den, mode);
+}
+
+
+bigint bigdecimal::round(bigint quotient, const bigint &rem, const bigint &den, rounding_mode mode)
+{
+    if (rem == bigint(0))
+        return quotient;
+    // A non-zero remainder has the sign of the numerator
+    bool negative = (rem.getSign() * den.getSign() == -1);
+
+    // Compare twice the dropped remainder with the divisor to place it below, at, or above one half
+    bigint twice_rem = rem;
+    if (twice_rem.getSign() == -1)
+        twice_rem.negate();
+    twice_rem += twice_rem;
+    bigint den_abs = den;
+    if (den_abs.getSign() == -1)
+        den_abs.negate();
+    int half = (twice_rem < den_abs) ? -1 : (twice_rem == den_abs) ? 0 : 1;
+
+    bool away = false; // whether the magnitude of the truncated quotient is increased by one
+    switch (mode)
+    {
+    case rounding_mode::down:
+        break;
+    case rounding_mode::up:
+        away = true;
+        break;
+    case rounding_mode::floor:
+        away = negative;
+        break;
+    case rounding_mode::ceiling:
+        away = !negative;
+        break;
+    case rounding_mode::half_up:
+        away = (half >= 0);
+        break;
+    case rounding_mode::half_down:
+        away = (half > 0);
+        break;
+    case rounding_mode::half_even:
+        away = (half > 0) || (half == 0 && quotient.getDigit(0) % 2 == 1);
+        break;
+    }
+    if (away)
+        quotient += bigint(negative ? -1 : 1);
+    return quotient;
+}
+
+
+bigdecimal bigdecimal::rescale(int32_t new_scale, rounding_mode mode) const
+{
+    bigdecimal result = *this;
+    result.scale = new_scale;
+    if (new_scale >= scale)
+    {
+        // Exact: one shift of the digits
+        result.coefficient.mulPow10(size_t(int64_t(new_scale) - scale));
+        return result;
+    }
+
+    // Split off the dropped digits in one pass, then round on the remainder
+    size_t dropped = size_t(int64_t(scale) - new_scale);
+    bigint rem = result.coefficient.divmodPow10(dropped);
+    result.coefficient = round(result.coefficient, rem, bigint(1).mulPow10(dropped), mode);
+    return result;
+}
+
+
+bigint bigdecimal::align(bigdecimal &lhs, const bigdecimal &rhs)
+{
+    bigint coefficient_rhs = rhs.coefficient;
+    if (lhs.scale < rhs.scale)
+        lhs = lhs.rescale(rhs.scale);
+    else
+        coefficient_rhs.mulPow10(size_t(int64_t(lhs.scale) - rhs.scale));
+    return coefficient_rhs;
+}
+
+
+bigdecimal &bigdecimal::operator+=(const bigdecimal &rhs)
+{
+    coefficient += align(*this, rhs);
+    return *this;
+}
+
+
+bigdecimal &bigdecimal::operator-=(const bigdecimal &rhs)
+{
+    coefficient -= align(*this, rhs);
+    return *this;
+}
+
+
+bigdecimal &bigdecimal::operator*=(const bigdecimal &rhs)
+{
+    coefficient *= rhs.coefficient;
+    scale = checkedScale(int64_t(scale) + rhs.scale);
+    return *this;
+}
+
+
+void bigdecimal::negate()
+{
+    coefficient.negate();
+}
+
+
+bigdecimal divide(const bigdecimal &lhs, const bigdecimal &rhs, int32_t scale, rounding_mode mode)
+{
+    // lhs / rhs = (c_l * 10^(s_r + scale - s_l)) / c_r at the requested scale; shift whichever side needs it
+    int64_t exponent = int64_t(rhs.getScale()) + scale - lhs.getScale();
+    bigint num = lhs.getCoefficient();
+    bigint den = rhs.getCoefficient();
+    if (exponent >= 0)
+        num.mulPow10(size_t(exponent));
+    else
+        den.mulPow10(size_t(-exponent));
+    return bigdecimal(bigdecimal::roundedQuotient(num, den, mode), scale);
+}
+
+
+bigdecimal operator-(const bigdecimal &opr)
+{
+    bigdecimal result = opr; // Make a copy of the bigdecimal
+    result.negate(); // Negate the copied bigdecimal
+    return result; // Return the negated bigdecimal
+}
+
+
+bigdecimal operator+(bigdecimal lhs, const bigdecimal &rhs)
+{
+    return lhs += rhs; // Use the compound addition-assignment operator
+}
+
+
+bigdecimal operator-(bigdecimal lhs, const bigdecimal &rhs)
+{
+    return lhs -= rhs; // Use the compound subtraction-assignment operator
+}
+
+
+bigdecimal operator*(bigdecimal lhs, const bigdecimal &rhs)
+{
+    return lhs *= rhs; // Use the compound multiplication-assignment operator
+}
+
+
+bool operator==(const bigdecimal &lhs, const bigdecimal &rhs)
+{
+    // Compare at the common scale
+    int32_t scale = std::max(lhs.getScale(), rhs.getScale());
+    return lhs.rescale(scale).getCoefficient() == rhs.rescale(scale).getCoefficient();
+}
+
+
+bool operator!=(const bigdecimal &lhs, const bigdecimal &rhs)
+{
+    return !(lhs == rhs); // Utilize the overloaded equality operator
+}
+
+
+bool operator<(const bigdecimal &lhs, const bigdecimal &rhs)
+{
+    // Compare at the common scale
+    int32_t scale = std::max(lhs.getScale(), rhs.getScale());
+    return lhs.rescale(scale).getCoefficient() < rhs.rescale(scale).getCoefficient();
+}
+
+
+bool operator<=(const bigdecimal &lhs, const bigdecimal &rhs)
+{
+    return !(rhs < lhs); // Utilizing the operator< for comparison.
+}
+
+
+bool operator>(const bigdecimal &lhs, const bigdecimal &rhs)
+{
+    return rhs < lhs; // Utilizing the operator< for comparison.
+}
+
+
+bool operator>=(const bigdecimal &lhs, const bigdecimal &rhs)
+{
+    return !(lhs < rhs); // Utilizing the operator< for comparison.
+}
+
+
+string to_string(const bigdecimal &opr)
+{
+    string str = to_string(opr.getCoefficient());
+    int32_t scale = opr.getScale();
+    bool negative = (str[0] == '-');
+    if (negative)
+        str.erase(0, 1);
+    if (scale < 0)
+        str.append(size_t(-int64_t(scale)), '0');
+    else if (scale > 0)
+    {
+        // Pad so that at least one digit precedes the decimal point
+        if (str.size() <= size_t(scale))
+            str.insert(0, size_t(scale) + 1 - str.size(), '0');
+        str.insert(str.size() - size_t(scale), 1, '.');
+    }
+    return negative ? "-" + str : str;
+}
+
+
+ostream &operator<<(ostream &out, const bigdecimal &opr)
+{
+    return out << to_string(opr);
+}
@@ -8,22 +8,181 @@
  * @copyright Copyright (c) 2023
  * 
  */
+#pragma once
 #include <iostream>
 #include <cstdint>
 #include <vector>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#if __has_include(<format>)
+#include <format>
+#endif
 
 using std::invalid_argument;
 using std::ostream;
 using std::string;
 using std::vector;
 
+class bigint;
+
+/** @brief Opt-in expression templates: arithmetic chains started with lazy() are evaluated in one pass. */
+namespace bigint_expr
+{
+    /** @brief Trait marking the node types of a lazy expression. */
+    template <typename E>
+    struct is_expression : std::false_type
+    {
+    };
+
+    struct evaluator;
+}
+
+template <size_t N>
+struct static_bigint;
+
 /** @brief Class representing an arbitrary-precision integer. */
 class bigint
 {
 private:
+    /**
+     * @brief Storage of the digit vector.
+     * With BIGINT_COPY_ON_WRITE defined, copies share one reference-counted vector and a bigint
+     * detaches its own copy on the first mutation while shared, so copying a huge value is O(1).
+     * Otherwise this is a plain vector. Reads never detach; only edit() and the mutating members do.
+     */
+    class digit_storage
+    {
+#ifdef BIGINT_COPY_ON_WRITE
+        /** @brief Shared vector, null until first written and after a move. */
+        std::shared_ptr<vector<uint8_t>> buffer;
+#else
+        vector<uint8_t> buffer;
+#endif
+
+#ifdef BIGINT_CACHE_HASH
+        /** @brief Hash digest of the digits, 0 while not computed. Reset by edit(). */
+        mutable std::atomic<size_t> hash_cache{0};
+#endif
+
+    public:
+        digit_storage() = default;
+
+#ifdef BIGINT_CACHE_HASH
+        // The cached digest stays valid for copies, which hold the same digits
+        digit_storage(const digit_storage &rhs) : buffer(rhs.buffer), hash_cache(rhs.getCachedHash()) {}
+
+        digit_storage(digit_storage &&rhs) noexcept : buffer(std::move(rhs.buffer)), hash_cache(rhs.getCachedHash())
+        {
+            rhs.setCachedHash(0);
+        }
+
+        digit_storage &operator=(const digit_storage &rhs)
+        {
+            buffer = rhs.buffer;
+            setCachedHash(rhs.getCachedHash());
+            return *this;
+        }
+
+        digit_storage &operator=(digit_storage &&rhs) noexcept
+        {
+            buffer = std::move(rhs.buffer);
+            setCachedHash(rhs.getCachedHash());
+            rhs.setCachedHash(0);
+            return *this;
+        }
+
+        size_t getCachedHash() const { return hash_cache.load(std::memory_order_relaxed); }
+        void setCachedHash(size_t digest) const { hash_cache.store(digest, std::memory_order_relaxed); }
+#endif
+
+#ifdef BIGINT_COPY_ON_WRITE
+        digit_storage(vector<uint8_t> opr) : buffer(std::make_shared<vector<uint8_t>>(std::move(opr))) {}
+#else
+        digit_storage(vector<uint8_t> opr) : buffer(std::move(opr)) {}
+#endif
+
+        /** @brief The digits of zero, read in place of a null or empty buffer. */
+        static const vector<uint8_t> &zero()
+        {
+            static const vector<uint8_t> digits{0};
+            return digits;
+        }
+
+        /** @brief Read-only access to the digits. A storage that was never written or was moved from reads as zero. */
+        const vector<uint8_t> &view() const
+        {
+#ifdef BIGINT_COPY_ON_WRITE
+            return (buffer && !buffer->empty()) ? *buffer : zero();
+#else
+            return buffer.empty() ? zero() : buffer;
+#endif
+        }
+
+        /** @brief Drops the digits without allocating, leaving a storage that reads as zero. */
+        void clear() noexcept
+        {
+#ifdef BIGINT_CACHE_HASH
+            setCachedHash(0);
+#endif
+#ifdef BIGINT_COPY_ON_WRITE
+            buffer.reset();
+#else
+            buffer.clear();
+#endif
+        }
+
+        /** @brief Writable access to the digits, detaching from other copies first if shared.
+         *  Copies in other threads may be read or destroyed concurrently; the same bigint must not be.
+         */
+        vector<uint8_t> &edit()
+        {
+#ifdef BIGINT_CACHE_HASH
+            setCachedHash(0);
+#endif
+#ifdef BIGINT_COPY_ON_WRITE
+            if (!buffer)
+                buffer = std::make_shared<vector<uint8_t>>(zero());
+            else if (buffer.use_count() > 1)
+                buffer = std::make_shared<vector<uint8_t>>(*buffer);
+            else
+                // use_count() is a relaxed load. Pair it with the release of the last other owner
+                // so that owner's reads of the digits happen before the writes that follow.
+                std::atomic_thread_fence(std::memory_order_acquire);
+            if (buffer->empty())
+                buffer->push_back(0);
+            return *buffer;
+#else
+            if (buffer.empty())
+                buffer.push_back(0);
+            return buffer;
+#endif
+        }
+
+        operator const vector<uint8_t> &() const { return view(); }
+
+        size_t size() const { return view().size(); }
+        bool empty() const { return view().empty(); }
+        uint8_t back() const { return view().back(); }
+        uint8_t operator[](size_t i) const { return view()[i]; }
+        void push_back(uint8_t digit) { edit().push_back(digit); }
+        void pop_back() { edit().pop_back(); }
+        void resize(size_t len) { edit().resize(len); }
+
+        template <typename It>
+        void assign(It first, It last) { edit().assign(first, last); }
+    };
+
     /** @brief Vector of digits representing the bigint in base 10. */
-    vector<uint8_t> digits;
+    digit_storage digits;
 
     /** @brief Sign of the bigint, 1 for positive, -1 for negative. */
     int8_t sign = 1;
@@ -59,6 +218,79 @@ private:
     /** @brief Exception for string initialization starting with zero. */
     inline static invalid_argument zero_initializing_string = invalid_argument("Initializing string should not start with zero!");
 
+    /** @brief Exception for division by zero. */
+    inline static invalid_argument division_by_zero = invalid_argument("Division by zero!");
+
+    /** @brief Compares the magnitudes of two digit vectors without leading zeros.
+     *  @return Negative, zero or positive if |lhs| is less than, equal to or greater than |rhs|.
+     */
+    static int compareMagnitude(const vector<uint8_t> &lhs, const vector<uint8_t> &rhs);
+
+    /** @brief Factor length, in digits, above which operator*= switches from schoolbook to Karatsuba. */
+    static constexpr size_t karatsuba_threshold = 40;
+
+    /** @brief Divisor and quotient length, in digits, above which divmod switches from long division to recursive division. */
+    static constexpr size_t division_threshold = 60;
+
+    /** @brief Adds the product of two digit polynomials of n coefficients each into out[0, 2n), without carrying.
+     *  @param lhs Coefficients of the first factor, least significant first.
+     *  @param rhs Coefficients of the second factor, least significant first.
+     *  @param n Number of coefficients of each factor.
+     *  @param out Columns the product is added to.
+     *  @param step Called with the completed fraction at every Karatsuba step; may throw to abandon.
+     *  @param done The fraction of the whole multiplication completed before this call.
+     *  @param share The fraction of the whole multiplication this call accounts for.
+     */
+    template <typename Step>
+    static void mulColumns(const uint64_t *lhs, const uint64_t *rhs, size_t n, uint64_t *out, Step &step, double done, double share);
+
+    /** @brief Long division of the magnitudes, one digit at a time. Leaves the quotient in the current bigint.
+     *  @param divisor The positive divisor.
+     *  @return The non-negative remainder.
+     */
+    bigint divmodLong(const bigint &divisor);
+
+    /** @brief Recursive (Burnikel-Ziegler) division of the magnitudes. Leaves the quotient in the current bigint.
+     *  @param divisor The positive divisor.
+     *  @return The non-negative remainder.
+     */
+    bigint divmodRecursive(const bigint &divisor);
+
+    /** @brief Divides a by b, where b has n digits, its top digit is at least 5, and a < b * 10^n.
+     *  @param a The non-negative dividend, replaced by the remainder.
+     *  @param b The divisor.
+     *  @param n The number of digits of b.
+     *  @return The quotient, below 10^n.
+     */
+    static bigint divide2n1n(bigint &a, const bigint &b, size_t n);
+
+    /** @brief Divides a12 * 10^n + a3 by b = b1 * 10^n + b2, where a12 < b * 10^n; a step of divide2n1n.
+     *  @param a12 The upper part of the dividend, replaced by the remainder.
+     *  @param a3 The lower n digits of the dividend.
+     *  @param b The divisor.
+     *  @param b1 The upper n digits of b.
+     *  @param b2 The lower n digits of b.
+     *  @param n Half the number of digits of b.
+     *  @return The quotient, below 10^n.
+     */
+    static bigint divide3n2n(bigint &a12, const bigint &a3, const bigint &b, const bigint &b1, const bigint &b2, size_t n);
+
+    /** @brief Exception for a conversion base outside [2, 36]. */
+    inline static invalid_argument invalid_base = invalid_argument("Base should be between 2 and 36!");
+
+    /** @brief Converts the magnitude to little-endian base 2^32 words.
+     *  @param step Called with the fraction of digits consumed every few thousand digits; may throw to abandon.
+     *  @return Vector of words, empty if the bigint is zero.
+     */
+    template <typename Step>
+    vector<uint32_t> toWords(Step &&step) const;
+
+    /** @brief Implements to_chars, calling step(fraction) at regular points of the quadratic conversions.
+     *  @param step Called with the completed fraction of the work; may throw to abandon the conversion.
+     */
+    template <typename Step>
+    static std::to_chars_result toChars(char *first, char *last, const bigint &opr, int base, Step &&step);
+
 public:
     /** @brief Constructs a new bigint initialized to zero. */
     bigint();
@@ -79,6 +311,12 @@ public:
      */
     bigint(const bigint &rhs);
 
+    /**
+     * @brief Move constructor, leaves rhs as zero
+     * @param rhs 
+     */
+    bigint(bigint &&rhs) noexcept;
+
 
     /** @brief Assigns a bigint to the current bigint.
      *  @param rhs The bigint to assign from.
@@ -86,6 +324,12 @@ public:
      */
     bigint &operator=(const bigint &rhs);
 
+    /** @brief Moves a bigint into the current bigint, leaving rhs as zero.
+     *  @param rhs The bigint to move from.
+     *  @return Reference to the current bigint after assignment.
+     */
+    bigint &operator=(bigint &&rhs) noexcept;
+
 
     /** @brief Adds a bigint to the current bigint.
      *  @param rhs The bigint to add.
@@ -105,6 +349,46 @@ public:
      */
     bigint &operator*=(const bigint &rhs);
 
+    /** @brief Multiplies a bigint with the current bigint, reporting progress.
+     *  @param rhs The bigint to multiply with.
+     *  @param step Called with the completed fraction at every Karatsuba recursion step above karatsuba_threshold,
+     *  and every 1024 rows of a schoolbook product; it may throw to abandon the multiplication, which leaves
+     *  the current bigint unchanged.
+     *  @return Reference to the current bigint after multiplication.
+     */
+    template <typename Step>
+    bigint &multiply(const bigint &rhs, Step &&step);
+
+    /** @brief Divides the current bigint by another, truncating toward zero.
+     *  @param rhs The bigint to divide by, must not be zero.
+     *  @return Reference to the current bigint after division.
+     */
+    bigint &operator/=(const bigint &rhs);
+
+    /** @brief Replaces the current bigint with its remainder modulo another, which has the sign of the dividend.
+     *  @param rhs The bigint to divide by, must not be zero.
+     *  @return Reference to the current bigint after the operation.
+     */
+    bigint &operator%=(const bigint &rhs);
+
+    /** @brief Divides the current bigint by another, truncating toward zero, and returns the remainder.
+     *  @param rhs The bigint to divide by, must not be zero.
+     *  @return The remainder, which has the sign of the dividend.
+     */
+    bigint divmod(const bigint &rhs);
+
+    /** @brief Multiplies the current bigint by 10^exponent, which is a shift of the base 10 digits.
+     *  @param exponent The power of ten.
+     *  @return Reference to the current bigint after multiplication.
+     */
+    bigint &mulPow10(size_t exponent);
+
+    /** @brief Divides the current bigint by 10^exponent, truncating toward zero, by splitting off the low digits.
+     *  @param exponent The power of ten.
+     *  @return The remainder, which has the sign of the dividend.
+     */
+    bigint divmodPow10(size_t exponent);
+
     /** @brief Negates the current bigint. */
     void negate();
 
@@ -117,6 +401,41 @@ public:
      *  @return Vector of digits of the bigint.
      */
     vector<uint8_t> getDigits() const;
+
+    /** @brief Gets the number of decimal digits of the bigint, 1 for zero, without copying them.
+     *  @return The digit count.
+     */
+    size_t getDigitCount() const;
+
+    /** @brief Gets one digit of the bigint without copying the others.
+     *  @param index Position of the digit, 0 being the least significant; must be below the digit count.
+     *  @return The digit at index.
+     */
+    uint8_t getDigit(size_t index) const;
+
+    /** @brief Constructs a bigint by evaluating a lazy expression.
+     *  @param expr The expression to evaluate, see bigint_expr::lazy.
+     */
+    template <typename E, typename = std::enable_if_t<bigint_expr::is_expression<E>::value>>
+    bigint(const E &expr);
+
+    /** @brief Evaluates a lazy expression directly into the current bigint.
+     *  @param expr The expression to evaluate, see bigint_expr::lazy.
+     *  @return Reference to the current bigint after assignment.
+     */
+    template <typename E, typename = std::enable_if_t<bigint_expr::is_expression<E>::value>>
+    bigint &operator=(const E &expr);
+
+    friend struct bigint_expr::evaluator;
+    friend struct bigint_hash;
+    friend struct bigint_equal;
+    friend bool operator==(const bigint &lhs, const bigint &rhs);
+    template <size_t N>
+    friend struct static_bigint;
+    friend std::to_chars_result to_chars(char *first, char *last, const bigint &opr, int base);
+    friend string to_string(const bigint &opr, int base);
+    template <typename Step>
+    friend string to_string(const bigint &opr, int base, Step &&step);
 };
 
 // Implementation details have inline comments explaining complex logic or important steps.
@@ -152,6 +471,22 @@ bigint operator-(bigint lhs, const bigint &rhs);
  */
 bigint operator*(bigint lhs, const bigint &rhs);
 
+/**
+ * @brief Divides one bigint by another, truncating toward zero.
+ * @param lhs The dividend.
+ * @param rhs The divisor, must not be zero.
+ * @return The quotient of lhs and rhs.
+ */
+bigint operator/(bigint lhs, const bigint &rhs);
+
+/**
+ * @brief Computes the remainder of dividing one bigint by another.
+ * @param lhs The dividend.
+ * @param rhs The divisor, must not be zero.
+ * @return The remainder, which has the sign of lhs.
+ */
+bigint operator%(bigint lhs, const bigint &rhs);
+
 /**
  * @brief Compares two bigint numbers for equality.
  * @param lhs The left-hand side bigint.
@@ -208,6 +543,156 @@ bool operator>=(const bigint &lhs, const bigint &rhs);
  */
 ostream &operator<<(ostream &out, const bigint &opr);
 
+/**
+ * @brief Writes the representation of a bigint in the given base into [first, last), like std::to_chars.
+ * Base 10 is a reversed copy of the stored digits. Every other base first converts the decimal digits to 32-bit words,
+ * which is quadratic in the number of digits; bases 2, 4, 8, 16 and 32 are then read off the words in one linear pass.
+ * @param first Start of the output buffer.
+ * @param last End of the output buffer.
+ * @param opr The bigint to be written.
+ * @param base The base to write in, between 2 and 36. Digits above 9 are lowercase letters.
+ * @return {end of written characters, errc()} on success, {last, errc::value_too_large} if the buffer is too small.
+ */
+std::to_chars_result to_chars(char *first, char *last, const bigint &opr, int base = 10);
+
+/**
+ * @brief Converts a bigint to its string representation in the given base.
+ * @param opr The bigint to be converted.
+ * @param base The base to convert to, between 2 and 36.
+ * @return The string representation, with a leading '-' if negative.
+ */
+string to_string(const bigint &opr, int base = 10);
+
+/**
+ * @brief Converts a bigint to its string representation in the given base, reporting progress.
+ * @param opr The bigint to be converted.
+ * @param base The base to convert to, between 2 and 36.
+ * @param step Called with the completed fraction every few thousand digits of the conversions to and from
+ * binary words, which are quadratic; it may throw to abandon the conversion. Base 10 never calls it.
+ * @return The string representation, with a leading '-' if negative.
+ */
+template <typename Step>
+string to_string(const bigint &opr, int base, Step &&step);
+
+/**
+ * @brief Hash function object for bigint, also usable with int64_t and string_view keys for heterogeneous lookup.
+ * Equal values hash equally across all three key types. The digits are hashed most significant first,
+ * eight at a time, so no string or temporary bigint is built. With BIGINT_CACHE_HASH defined, the digest of a
+ * bigint is cached in the object until its digits change.
+ */
+struct bigint_hash
+{
+    using is_transparent = void;
+
+    size_t operator()(const bigint &opr) const;
+    size_t operator()(int64_t number) const;
+    size_t operator()(std::string_view str) const;
+
+private:
+    /** @brief Mixes one word of eight digits into the running hash. */
+    static uint64_t absorb(uint64_t h, uint64_t word);
+
+    /** @brief Reverses the byte order of a word. */
+    static uint64_t byteSwap(uint64_t word);
+
+    /** @brief Final avalanche of the digest with the sign. */
+    static size_t finish(uint64_t digest, bool negative);
+
+    /** @brief Digest of stored digits (least significant first). */
+    static uint64_t digestDigits(const vector<uint8_t> &digits);
+
+    /** @brief Digest of decimal text (most significant first), the same stream as digestDigits. */
+    static uint64_t digestText(std::string_view text);
+};
+
+/**
+ * @brief Equality function object matching bigint_hash, comparing a bigint with another bigint,
+ * an int64_t or a decimal string_view without constructing a temporary bigint.
+ */
+struct bigint_equal
+{
+    using is_transparent = void;
+
+    bool operator()(const bigint &lhs, const bigint &rhs) const;
+    bool operator()(const bigint &lhs, int64_t rhs) const;
+    bool operator()(int64_t lhs, const bigint &rhs) const { return (*this)(rhs, lhs); }
+    bool operator()(const bigint &lhs, std::string_view rhs) const;
+    bool operator()(std::string_view lhs, const bigint &rhs) const { return (*this)(rhs, lhs); }
+};
+
+/** @brief std::hash support so that bigint can key unordered containers directly. */
+template <>
+struct std::hash<bigint>
+{
+    size_t operator()(const bigint &opr) const { return bigint_hash()(opr); }
+};
+
+/**
+ * @brief Parsed options of a std::format replacement field for bigint.
+ * Grammar: [[fill]align][#][width][grouping][type], where align is one of "<>^",
+ * grouping is one of ",_'" and type is one of "dbBoxX".
+ */
+struct bigint_format_spec
+{
+    /** @brief Padding character. */
+    char fill = ' ';
+
+    /** @brief Alignment within the width, right by default as for built-in integers. */
+    char align = '>';
+
+    /** @brief Whether to emit a 0b/0/0x base prefix. */
+    bool alternate = false;
+
+    /** @brief Minimum field width. */
+    size_t width = 0;
+
+    /** @brief Digit group separator, '\0' for none. Groups are 3 digits in base 10 and 4 otherwise. */
+    char grouping = '\0';
+
+    /** @brief Presentation type. */
+    char type = 'd';
+
+    /** @brief Parses the options in [first, last), stopping at the closing '}'.
+     *  @param first Start of the spec.
+     *  @param last End of the format string.
+     *  @return Pointer to the first unparsed character, or nullptr if the spec is invalid.
+     */
+    constexpr const char *parse(const char *first, const char *last)
+    {
+        auto isAlign = [](char ch) { return ch == '<' || ch == '>' || ch == '^'; };
+        const char *p = first;
+        // fill is only recognized when directly followed by an alignment
+        if (last - p >= 2 && isAlign(p[1]) && p[0] != '{' && p[0] != '}')
+        {
+            fill = p[0];
+            align = p[1];
+            p += 2;
+        }
+        else if (p != last && isAlign(*p))
+            align = *p++;
+        if (p != last && *p == '#')
+        {
+            alternate = true;
+            p++;
+        }
+        for (; p != last && *p >= '0' && *p <= '9'; p++)
+            width = width * 10 + size_t(*p - '0');
+        if (p != last && (*p == ',' || *p == '_' || *p == '\''))
+            grouping = *p++;
+        if (p != last && std::string_view("dbBoxX").find(*p) != std::string_view::npos)
+            type = *p++;
+        if (p != last && *p != '}')
+            return nullptr;
+        return p;
+    }
+
+    /** @brief Formats a bigint according to the parsed options.
+     *  @param opr The bigint to be formatted.
+     *  @return The formatted string, padded to the width.
+     */
+    string apply(const bigint &opr) const;
+};
+
 
 /** implementation starts **/
 
@@ -224,12 +709,14 @@ bigint::bigint(int64_t number)
     setSign(new_sign);
     if(!number) // if number is zero
         setDigits({0});
+    vector<uint8_t> digits_new;
     while (number)
     {
-        digits.push_back(uint8_t(new_sign * int8_t(number % 10)));
+        digits_new.push_back(uint8_t(new_sign * int8_t(number % 10)));
         number /= 10;
     }
-    
+    if (!digits_new.empty())
+        setDigits(digits_new);
 }
 
 bigint::bigint(const string &str)
@@ -271,6 +758,13 @@ bigint::bigint(const bigint &rhs)
     *this = rhs;
 }
 
+bigint::bigint(bigint &&rhs) noexcept : digits(std::move(rhs.digits)), sign(rhs.sign)
+{
+    // Empty (or null with BIGINT_COPY_ON_WRITE) digits read as zero, so rhs is left as zero without allocating
+    rhs.digits.clear();
+    rhs.sign = 1;
+}
+
 bigint &bigint::operator=(const bigint &rhs)
 {
     sign = rhs.sign; // Copy the sign from the right-hand side (rhs)
@@ -278,10 +772,22 @@ bigint &bigint::operator=(const bigint &rhs)
     return *this; // Return the current object for chaining assignments
 }
 
+bigint &bigint::operator=(bigint &&rhs) noexcept
+{
+    if (this == &rhs)
+        return *this;
+    sign = rhs.sign;
+    digits = std::move(rhs.digits);
+    rhs.digits.clear();
+    rhs.sign = 1;
+    return *this;
+}
+
 bigint &bigint::add(const bigint &rhs)
 {
     const vector<uint8_t> &digits_rhs = rhs.digits; // Digits of the right-hand side bigint
-    size_t len_l = digits.size(); // Length of current bigint's digits
+    vector<uint8_t> &digits_l = digits.edit(); // Writable digits, detached once if shared
+    size_t len_l = digits_l.size(); // Length of current bigint's digits
     size_t len_r = digits_rhs.size(); // Length of rhs bigint's digits
     size_t i = 0;   
     uint8_t carry = false; // To store carry-over during addition
@@ -289,35 +795,36 @@ bigint &bigint::add(const bigint &rhs)
     // Add corresponding digits of both numbers and handle carry
     for (; i < std::min(len_l, len_r); i++)
     {
-        uint8_t sum_new = uint8_t(digits[i] + digits_rhs[i] + carry);
-        digits[i] = sum_new % 10; // Store the last digit of sum
+        uint8_t sum_new = uint8_t(digits_l[i] + digits_rhs[i] + carry);
+        digits_l[i] = sum_new % 10; // Store the last digit of sum
         carry = (sum_new >= 10); // Determine if there's a carry for next digits
     }
 
     // Handle remaining digits and carry for the larger number
     for (; i < len_l; i++)
     {
-        uint8_t sum_new = digits[i] + carry;
-        digits[i] = sum_new % 10;
+        uint8_t sum_new = digits_l[i] + carry;
+        digits_l[i] = sum_new % 10;
         carry = (sum_new >= 10);
     }
     for (; i < len_r; i++)
     {
         uint8_t sum_new = uint8_t(digits_rhs[i] + carry);
-        digits.push_back(sum_new % 10);
+        digits_l.push_back(sum_new % 10);
         carry = (sum_new >= 10);
     }
 
     // Add a new digit if there's a carry left after processing all digits
     if (carry)
-        digits.push_back(1);
+        digits_l.push_back(1);
     return *this;
 }
 
 bigint &bigint::minus(const bigint &rhs)
 {
     const vector<uint8_t> &digits_rhs = rhs.digits;
-    size_t len_l = digits.size();
+    vector<uint8_t> &digits_l = digits.edit();
+    size_t len_l = digits_l.size();
     size_t len_r = digits_rhs.size();
     size_t i = 0;
     uint8_t borrow = false; // To store borrow during subtraction
@@ -325,16 +832,16 @@ bigint &bigint::minus(const bigint &rhs)
     // Subtract corresponding digits of both numbers and handle borrow
     for (; i < std::min(len_l, len_r); i++)
     {
-        uint8_t sum_new = uint8_t(digits[i] + 10 - digits_rhs[i] - borrow);
-        digits[i] = sum_new % 10; // Store the last digit of sum
+        uint8_t sum_new = uint8_t(digits_l[i] + 10 - digits_rhs[i] - borrow);
+        digits_l[i] = sum_new % 10; // Store the last digit of sum
         borrow = (sum_new < 10); // Determine if there's a borrow for next digits
     }
 
     // Handle remaining digits and borrow for the larger number
     for (; i < len_l; i++)
     {
-        uint8_t sum_new = uint8_t(digits[i] + 10 - borrow);
-        digits[i] = sum_new % 10;
+        uint8_t sum_new = uint8_t(digits_l[i] + 10 - borrow);
+        digits_l[i] = sum_new % 10;
         borrow = (sum_new < 10);
     }
 
@@ -382,7 +889,7 @@ bigint &bigint::operator+=(const bigint &rhs)
         }
     }
     // If the result is zero, set the sign to positive.
-    if (digits[0] == 0)
+    if (digits.back() == 0)
         setSign(1);
     return *this;
 }
@@ -398,46 +905,343 @@ bigint &bigint::operator-=(const bigint &rhs)
 
 bigint &bigint::operator*=(const bigint &rhs)
 {
-    // Negate the current bigint if rhs is negative.
-    if (rhs.sign == -1)
-        negate();
+    return multiply(rhs, [](double) {});
+}
 
+
+template <typename Step>
+bigint &bigint::multiply(const bigint &rhs, Step &&step)
+{
+    const vector<uint8_t> &digits_l = digits; // Digits of the current bigint.
     const vector<uint8_t> &digits_rhs = rhs.digits; // Digits of the right-hand side bigint.
-    size_t len_l = digits.size(); // Length of current bigint's digits.
+    size_t len_l = digits_l.size(); // Length of current bigint's digits.
     size_t len_r = digits_rhs.size(); // Length of rhs bigint's digits.
-    uint8_t carry;      // To store carry-over during multiplication
-    bigint digits_sum;  // To store the sum of the products.
+    size_t len_short = std::min(len_l, len_r);
+
+    // Accumulate every digit product into the column of its position; a column ends up holding at most
+    // 81 * len_short, so the carries can be propagated once at the end.
+    vector<uint64_t> columns(len_l + len_r + len_short, 0);
+    if (len_short <= karatsuba_threshold)
+    {
+        for (size_t i = 0; i < len_l; i++)
+        {
+            if (i % 1024 == 1023)
+                step(double(i) / double(len_l));
+            uint64_t digit = digits_l[i];
+            if (!digit)
+                continue;
+            uint64_t *column = columns.data() + i; // Shift by i positions, equivalent to multiplying by 10^i.
+            for (size_t j = 0; j < len_r; j++)
+                column[j] += digit * digits_rhs[j];
+        }
+    }
+    else
+    {
+        // Cut the longer factor into pieces as long as the shorter one and multiply each piece with Karatsuba.
+        const vector<uint8_t> &digits_long = (len_l >= len_r) ? digits_l : digits_rhs;
+        const vector<uint8_t> &digits_short = (len_l >= len_r) ? digits_rhs : digits_l;
+        vector<uint64_t> factor(digits_short.begin(), digits_short.end());
+        vector<uint64_t> piece(len_short);
+        double share = double(len_short) / double(digits_long.size());
+        for (size_t offset = 0; offset < digits_long.size(); offset += len_short)
+        {
+            size_t count = std::min(len_short, digits_long.size() - offset);
+            std::fill(std::copy_n(digits_long.begin() + std::ptrdiff_t(offset), count, piece.begin()), piece.end(), 0);
+            double done = double(offset) / double(digits_long.size());
+            mulColumns(piece.data(), factor.data(), len_short, columns.data() + offset, step, done, std::min(share, 1.0 - done));
+        }
+    }
+
+    // Propagate the carries and keep the last digit of every column.
+    vector<uint8_t> product(columns.size());
+    uint64_t carry = 0;
+    for (size_t k = 0; k < columns.size(); k++)
+    {
+        uint64_t value = columns[k] + carry;
+        product[k] = uint8_t(value % 10);
+        carry = value / 10;
+    }
+
+    // Replace the current bigint's digits with the product's digits; the sign is the product of the signs.
+    int8_t new_sign = int8_t(sign * rhs.sign);
+    digits = std::move(product);
+    removeZeroAtStart();
+    setSign(digits.back() == 0 ? 1 : new_sign);
+    return *this;
+}
+
+
+template <typename Step>
+void bigint::mulColumns(const uint64_t *lhs, const uint64_t *rhs, size_t n, uint64_t *out, Step &step, double done, double share)
+{
+    if (n <= karatsuba_threshold)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            uint64_t digit = lhs[i];
+            if (!digit)
+                continue;
+            for (size_t j = 0; j < n; j++)
+                out[i + j] += digit * rhs[j];
+        }
+        return;
+    }
 
-    // Iterate over each digit of the current bigint.
-    for (size_t i = 0; i < len_l; i++)
+    step(done);
+
+    // Karatsuba with x = 10^low: (l1 x + l0)(r1 x + r0) = z2 x^2 + (z1 - z2 - z0) x + z0, where z1 = (l1 + l0)(r1 + r0).
+    // Nothing is carried, so z1 - z2 - z0 = l1 r0 + l0 r1 is non-negative column by column.
+    size_t low = n / 2, high = n - low;
+    vector<uint64_t> scratch(8 * high, 0);
+    uint64_t *sum_l = scratch.data(), *sum_r = sum_l + high;
+    uint64_t *z0 = sum_r + high, *z1 = z0 + 2 * high, *z2 = z1 + 2 * high;
+    for (size_t i = 0; i < high; i++)
+    {
+        sum_l[i] = lhs[low + i] + (i < low ? lhs[i] : 0);
+        sum_r[i] = rhs[low + i] + (i < low ? rhs[i] : 0);
+    }
+    // The three half products take about a third of the work each
+    mulColumns(lhs, rhs, low, z0, step, done, share / 3);
+    mulColumns(lhs + low, rhs + low, high, z2, step, done + share / 3, share / 3);
+    mulColumns(sum_l, sum_r, high, z1, step, done + 2 * share / 3, share / 3);
+    for (size_t i = 0; i < 2 * high; i++)
     {
-        bigint product; // To store the product of a single digit multiplication.
-        product.setDigits(vector<uint8_t>(i, 0)); // Add zeros for lower positions, equivalent to shifting in base 10.
+        z1[i] -= z0[i] + z2[i];
+        out[i] += z0[i];
+        out[i + low] += z1[i];
+        out[i + 2 * low] += z2[i];
+    }
+}
+
+
+bigint bigint::divmod(const bigint &rhs)
+{
+    if (rhs.digits.back() == 0)
+        throw division_by_zero;
+
+    // Divide the magnitudes; long division is quadratic, so long divisors with long quotients go recursive.
+    int8_t dividend_sign = sign;
+    int8_t quotient_sign = int8_t(sign * rhs.sign);
+    bigint divisor = rhs;
+    divisor.setSign(1);
+    setSign(1);
+    size_t len_r = divisor.digits.size();
+    bool recursive = (len_r > division_threshold && digits.size() > len_r + division_threshold);
+    bigint remainder = recursive ? divmodRecursive(divisor) : divmodLong(divisor);
+
+    // The remainder takes the sign of the dividend, the quotient the product of the signs; zero stays positive.
+    remainder.setSign(remainder.digits.back() == 0 ? 1 : dividend_sign);
+    setSign(digits.back() == 0 ? 1 : quotient_sign);
+    return remainder;
+}
+
 
-        carry = 0; 
-        // Multiply the current digit with each digit of rhs bigint.
-        for (size_t j = 0; j < len_r; j++)
+bigint bigint::divmodLong(const bigint &divisor)
+{
+    // Bring down one digit at a time, most significant first,
+    // and subtract the divisor from the running remainder as many times as it fits (at most 9).
+    const vector<uint8_t> &digits_l = digits;
+    const vector<uint8_t> &digits_rhs = divisor.digits;
+    vector<uint8_t> quotient(digits_l.size(), 0);
+    bigint remainder;
+    for (size_t i = digits_l.size(); i > 0; i--)
+    {
+        vector<uint8_t> &digits_rem = remainder.digits.edit();
+        if (digits_rem.back() == 0)
+            digits_rem[0] = digits_l[i - 1];
+        else
+            digits_rem.insert(digits_rem.begin(), digits_l[i - 1]);
+        uint8_t q = 0;
+        while (compareMagnitude(remainder.digits, digits_rhs) >= 0)
         {
-            uint8_t product_digit = uint8_t(digits[i] * digits_rhs[j] + carry);
-            product.digits.push_back(product_digit % 10); // Store the last digit of the product.
-            carry = product_digit / 10; // Carry for the next digit.
+            remainder.minus(divisor);
+            q++;
         }
+        quotient[i - 1] = q;
+    }
+    setDigits(quotient);
+    removeZeroAtStart();
+    return remainder;
+}
 
-        // Add remaining carry if present.
-        if (carry)
-            product.digits.push_back(carry);
 
-        // Add the product to the total sum.
-        digits_sum += product;
+bigint bigint::divmodRecursive(const bigint &divisor)
+{
+    // Scale both operands so the top digit of the divisor is at least 5, which keeps every
+    // quotient estimate of divide3n2n within 2 of the true value. The length does not change.
+    uint8_t factor = uint8_t(10 / (divisor.digits.back() + 1));
+    bigint b = divisor;
+    bigint a = *this;
+    if (factor > 1)
+    {
+        b *= bigint(factor);
+        a *= bigint(factor);
     }
 
-    // Replace the current bigint's digits with the sum's digits.
-    digits = digits_sum.digits;
+    // Schoolbook division in base 10^n, where n is the length of the divisor: every step divides
+    // a 2n-digit value by the n-digit divisor.
+    size_t n = b.digits.size();
+    const vector<uint8_t> &digits_a = a.digits;
+    size_t chunks = (digits_a.size() + n - 1) / n;
+    vector<uint8_t> quotient(chunks * n, 0);
+    bigint remainder;
+    for (size_t c = chunks; c > 0; c--)
+    {
+        size_t first = (c - 1) * n;
+        bigint chunk;
+        chunk.setDigits(vector<uint8_t>(digits_a.begin() + std::ptrdiff_t(first),
+                                        digits_a.begin() + std::ptrdiff_t(std::min(first + n, digits_a.size()))));
+        chunk.removeZeroAtStart();
+        remainder.mulPow10(n);
+        remainder += chunk;
+        bigint q = divide2n1n(remainder, b, n);
+        const vector<uint8_t> &digits_q = q.digits;
+        std::copy(digits_q.begin(), digits_q.end(), quotient.begin() + std::ptrdiff_t(first));
+    }
+    setDigits(quotient);
     removeZeroAtStart();
+    if (factor > 1)
+        remainder /= bigint(factor);
+    return remainder;
+}
+
+
+bigint bigint::divide2n1n(bigint &a, const bigint &b, size_t n)
+{
+    if (a.digits.size() <= n + division_threshold)
+    {
+        bigint q = a;
+        a = q.divmodLong(b);
+        return q;
+    }
+
+    // An odd length is padded with one zero digit, which keeps the top digit of b
+    bigint b_padded;
+    const bigint *divisor = &b;
+    bool pad = (n % 2 == 1);
+    if (pad)
+    {
+        a.mulPow10(1);
+        b_padded = b;
+        b_padded.mulPow10(1);
+        divisor = &b_padded;
+        n++;
+    }
+
+    // Split b into halves b1 b2 and a into a12 a3 a4, then divide twice with divide3n2n
+    size_t half = n / 2;
+    bigint b1 = *divisor;
+    bigint b2 = b1.divmodPow10(half);
+    bigint a12 = a;
+    bigint a34 = a12.divmodPow10(n);
+    bigint a3 = a34;
+    bigint a4 = a3.divmodPow10(half);
+    bigint q = divide3n2n(a12, a3, *divisor, b1, b2, half);
+    bigint q2 = divide3n2n(a12, a4, *divisor, b1, b2, half);
+    q.mulPow10(half);
+    q += q2;
+    if (pad)
+        a12.divmodPow10(1);
+    a = std::move(a12);
+    return q;
+}
+
+
+bigint bigint::divide3n2n(bigint &a12, const bigint &a3, const bigint &b, const bigint &b1, const bigint &b2, size_t n)
+{
+    // Estimate the quotient from the top digits: divide a12 by b1, or take 10^n - 1 if the top halves are equal
+    bigint q;
+    bigint a1 = a12;
+    a1.divmodPow10(n);
+    if (a1 == b1)
+    {
+        q = bigint(1).mulPow10(n) - bigint(1);
+        bigint shifted = b1;
+        shifted.mulPow10(n);
+        a12 -= shifted;
+        a12 += b1;
+    }
+    else
+        q = divide2n1n(a12, b1, n);
+
+    // Bring in a3 and subtract the part of q * b the estimate ignored; the estimate is at most 2 too large
+    a12.mulPow10(n);
+    a12 += a3;
+    a12 -= q * b2;
+    while (a12.sign == -1)
+    {
+        q -= bigint(1);
+        a12 += b;
+    }
+    return q;
+}
+
+
+bigint &bigint::operator/=(const bigint &rhs)
+{
+    divmod(rhs);
+    return *this;
+}
+
+
+bigint &bigint::operator%=(const bigint &rhs)
+{
+    return *this = divmod(rhs);
+}
+
+
+bigint &bigint::mulPow10(size_t exponent)
+{
+    // Shifting the digits by exponent places; zero stays a single digit
+    if (digits.back() != 0 && exponent)
+    {
+        vector<uint8_t> &digits_l = digits.edit();
+        digits_l.insert(digits_l.begin(), exponent, 0);
+    }
     return *this;
 }
 
 
+bigint bigint::divmodPow10(size_t exponent)
+{
+    bigint remainder;
+    const vector<uint8_t> &digits_l = digits;
+    size_t split = std::min(exponent, digits_l.size());
+    if (!split)
+        return remainder;
+
+    // The low digits form the remainder, the rest shift down to form the quotient
+    remainder.setDigits(vector<uint8_t>(digits_l.begin(), digits_l.begin() + std::ptrdiff_t(split)));
+    remainder.removeZeroAtStart();
+    remainder.setSign(remainder.digits.back() == 0 ? 1 : sign);
+    if (split == digits_l.size())
+    {
+        // Every digit went to the remainder, the quotient is zero
+        setDigits({0});
+        setSign(1);
+        return remainder;
+    }
+    vector<uint8_t> &digits_q = digits.edit();
+    digits_q.erase(digits_q.begin(), digits_q.begin() + std::ptrdiff_t(split));
+    removeZeroAtStart();
+    if (digits.back() == 0)
+        setSign(1);
+    return remainder;
+}
+
+
+int bigint::compareMagnitude(const vector<uint8_t> &lhs, const vector<uint8_t> &rhs)
+{
+    if (lhs.size() != rhs.size())
+        return (lhs.size() < rhs.size()) ? -1 : 1;
+    // Same length: the first different digit from the most significant end decides
+    for (size_t i = lhs.size(); i > 0; i--)
+        if (lhs[i - 1] != rhs[i - 1])
+            return (lhs[i - 1] < rhs[i - 1]) ? -1 : 1;
+    return 0;
+}
+
+
 
 
 
@@ -446,7 +1250,7 @@ void bigint::removeZeroAtStart()
 {
     // Removing zeros from the end of the vector until a non-zero digit is encountered
     // or the vector becomes empty.
-    while (digits.back() == 0 && digits.size() > 1)
+    while (!digits.empty() && digits.back() == 0 && digits.size() > 1)
         digits.pop_back();
 
     // If all digits are zeros, ensure the bigint is set to zero (not an empty vector).
@@ -467,6 +1271,18 @@ vector<uint8_t> bigint::getDigits() const
 }
 
 
+size_t bigint::getDigitCount() const
+{
+    return digits.size();
+}
+
+
+uint8_t bigint::getDigit(size_t index) const
+{
+    return digits[index];
+}
+
+
 void bigint::setDigits(const vector<uint8_t> &opr)
 {
     digits = opr; // Sets the bigint's digits to the provided vector
@@ -481,7 +1297,7 @@ void bigint::setSign(const int8_t &new_sign)
 
 void bigint::negate()
 {
-    if(digits[0] != 0)
+    if(digits.back() != 0)
         sign *= -1; // Flips the sign of the bigint unless it's 0 (invariable)
 }
 
@@ -512,16 +1328,28 @@ bigint operator*(bigint lhs, const bigint &rhs)
 }
 
 
-bool operator==(const bigint &lhs, const bigint &rhs)
+bigint operator/(bigint lhs, const bigint &rhs)
 {
-    // First, compare the signs. If they are different, bigint are not equal.
-    // 0 always has sign value 1 (invariant)
-    if (lhs.getSign() != rhs.getSign())
-        return false;
+    return lhs /= rhs; // Use the compound division-assignment operator
+}
+
+
+bigint operator%(bigint lhs, const bigint &rhs)
+{
+    return lhs %= rhs; // Use the compound remainder-assignment operator
+}
+
+
+bool operator==(const bigint &lhs, const bigint &rhs)
+{
+    // First, compare the signs. If they are different, bigint are not equal.
+    // 0 always has sign value 1 (invariant)
+    if (lhs.getSign() != rhs.getSign())
+        return false;
 
     // Then, compare the sizes of digit vectors.
-    vector<uint8_t> digits_lhs = lhs.getDigits();
-    vector<uint8_t> digits_rhs = rhs.getDigits();
+    const vector<uint8_t> &digits_lhs = lhs.digits;
+    const vector<uint8_t> &digits_rhs = rhs.digits;
     if (digits_lhs.size() != digits_rhs.size())
         return false;
 
@@ -563,11 +1391,11 @@ bool operator<(const bigint &lhs, const bigint &rhs)
     {
         int64_t i;
         // find the first different digit
-        for (i = int64_t(len_l - 1); i >= 0  && digits_lhs[uint8_t(i)] == digits_rhs[uint8_t(i)]; i--);
+        for (i = int64_t(len_l - 1); i >= 0  && digits_lhs[size_t(i)] == digits_rhs[size_t(i)]; i--);
         if (i < 0) // All digits are the same, hence not less than.
             return false;
         // For positive numbers, a smaller digit means smaller number and vice versa for negative numbers.
-        return (isPos && digits_lhs[uint8_t(i)] < digits_rhs[uint8_t(i)]) || (!isPos && digits_lhs[uint8_t(i)] > digits_rhs[uint8_t(i)]);
+        return (isPos && digits_lhs[size_t(i)] < digits_rhs[size_t(i)]) || (!isPos && digits_lhs[size_t(i)] > digits_rhs[size_t(i)]);
     }
     // If the number of digits is different, the number with fewer digits is smaller for positive numbers and larger for negative numbers.
     bool isShorter = len_l < len_r;
@@ -595,11 +1423,11 @@ bool operator<=(const bigint &lhs, const bigint &rhs)
     {
         int64_t i;
         // find the first different digit
-        for (i = int64_t(len_l - 1); i >= 0 && digits_lhs[uint8_t(i)] == digits_rhs[uint8_t(i)]; i--);
+        for (i = int64_t(len_l - 1); i >= 0 && digits_lhs[size_t(i)] == digits_rhs[size_t(i)]; i--);
         if (i < 0) // All digits are the same, also meets condition.
             return true;
         // For positive numbers, a smaller digit means smaller number and vice versa for negative numbers.
-        return (isPos && digits_lhs[uint8_t(i)] < digits_rhs[uint8_t(i)]) || (!isPos && digits_lhs[uint8_t(i)] > digits_rhs[uint8_t(i)]);
+        return (isPos && digits_lhs[size_t(i)] < digits_rhs[size_t(i)]) || (!isPos && digits_lhs[size_t(i)] > digits_rhs[size_t(i)]);
     }
     // If the number of digits is different, the number with fewer digits is smaller for positive numbers and larger for negative numbers.
     bool isShorter = len_l < len_r;
@@ -621,16 +1449,869 @@ bool operator>=(const bigint &lhs, const bigint &rhs)
 
 ostream &operator<<(ostream &out, const bigint &opr)
 {
-    vector<uint8_t> digits = opr.getDigits();
-    // Outputting the sign if negative
-    if (opr.getSign() == -1)
-        out << '-';
+    // Honour std::hex / std::oct, and write the whole number in one insertion so width applies to it
+    std::ios_base::fmtflags flags = out.flags();
+    int base = (flags & std::ios_base::hex) ? 16 : (flags & std::ios_base::oct) ? 8 : 10;
+    string str = to_string(opr, base);
+    if (flags & std::ios_base::uppercase)
+        std::transform(str.begin(), str.end(), str.begin(), [](char ch) { return char(std::toupper(ch)); });
+
+    // out << '\n'; // Newline after printing the bigint
+    return out << str;
+}
+
+
+template <typename Step>
+vector<uint32_t> bigint::toWords(Step &&step) const
+{
+    vector<uint32_t> words;
+    size_t i = digits.size();
+    // Feed nine decimal digits at a time, most significant first: words = words * 10^k + chunk
+    size_t take = (i % 9) ? i % 9 : 9;
+    for (size_t chunks = 0; i > 0; chunks++)
+    {
+        if (chunks % 256 == 255)
+            step(double(digits.size() - i) / double(digits.size()));
+        uint32_t chunk = 0;
+        uint32_t scale = 1;
+        for (size_t k = 0; k < take; k++)
+        {
+            chunk = chunk * 10 + digits[--i];
+            scale *= 10;
+        }
+        take = 9;
+
+        uint64_t carry = chunk;
+        for (uint32_t &word : words)
+        {
+            uint64_t cur = uint64_t(word) * scale + carry;
+            word = uint32_t(cur);
+            carry = cur >> 32;
+        }
+        if (carry)
+            words.push_back(uint32_t(carry));
+    }
+    return words;
+}
+
+
+template <typename Step>
+std::to_chars_result bigint::toChars(char *first, char *last, const bigint &opr, int base, Step &&step)
+{
+    if (base < 2 || base > 36)
+        throw bigint::invalid_base;
+    static constexpr char alphabet[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+    const vector<uint8_t> &digits = opr.digits;
+    size_t space = size_t(last - first);
+    bool negative = (opr.sign == -1);
+
+    if (base == 10)
+    {
+        // Digits are stored least significant first, so this is a reversed copy.
+        if (space < digits.size() + negative)
+            return {last, std::errc::value_too_large};
+        if (negative)
+            *first++ = '-';
+        for (size_t i = digits.size(); i > 0; i--)
+            *first++ = alphabet[digits[i - 1]];
+        return {first, std::errc()};
+    }
+
+    // The conversion to words takes the first half of the progress, unless the words are read off directly
+    bool single_bit = std::has_single_bit(unsigned(base));
+    double words_share = single_bit ? 1.0 : 0.5;
+    vector<uint32_t> words = opr.toWords([&step, words_share](double fraction) { step(fraction * words_share); });
+    if (words.empty())
+    {
+        if (space < 1)
+            return {last, std::errc::value_too_large};
+        *first++ = '0';
+        return {first, std::errc()};
+    }
+
+    if (single_bit)
+    {
+        // Power of two base: every output digit is a fixed k-bit field of the words.
+        size_t k = size_t(std::countr_zero(unsigned(base)));
+        size_t bits = 32 * words.size() - size_t(std::countl_zero(words.back()));
+        size_t count = (bits + k - 1) / k;
+        if (space < count + negative)
+            return {last, std::errc::value_too_large};
+        if (negative)
+            *first++ = '-';
+        for (size_t d = count; d > 0; d--)
+        {
+            size_t bit = (d - 1) * k;
+            size_t w = bit / 32;
+            size_t offset = bit % 32;
+            uint64_t field = words[w] >> offset;
+            if (offset + k > 32 && w + 1 < words.size())
+                field |= uint64_t(words[w + 1]) << (32 - offset);
+            *first++ = alphabet[field & uint64_t(base - 1)];
+        }
+        return {first, std::errc()};
+    }
+
+    // Other bases: repeated short division by the largest power of base that fits in 32 bits.
+    uint32_t chunk_base = uint32_t(base);
+    size_t chunk_len = 1;
+    while (uint64_t(chunk_base) * uint32_t(base) <= UINT32_MAX)
+    {
+        chunk_base *= uint32_t(base);
+        chunk_len++;
+    }
+    string reversed; // output digits, least significant first
+    double total_words = double(words.size());
+    for (size_t rounds = 0; !words.empty(); rounds++)
+    {
+        if (rounds % 256 == 255)
+            step(0.5 + 0.5 * (1.0 - double(words.size()) / total_words));
+        uint64_t rem = 0;
+        for (size_t i = words.size(); i > 0; i--)
+        {
+            uint64_t cur = (rem << 32) | words[i - 1];
+            words[i - 1] = uint32_t(cur / chunk_base);
+            rem = cur % chunk_base;
+        }
+        while (!words.empty() && words.back() == 0)
+            words.pop_back();
+        // Pad inner chunks with zeros, the most significant chunk stops at its last non-zero digit.
+        for (size_t k = 0; k < chunk_len && (rem || !words.empty()); k++)
+        {
+            reversed.push_back(alphabet[rem % uint32_t(base)]);
+            rem /= uint32_t(base);
+        }
+    }
+    if (space < reversed.size() + negative)
+        return {last, std::errc::value_too_large};
+    if (negative)
+        *first++ = '-';
+    return {std::copy(reversed.rbegin(), reversed.rend(), first), std::errc()};
+}
+
+
+std::to_chars_result to_chars(char *first, char *last, const bigint &opr, int base)
+{
+    return bigint::toChars(first, last, opr, base, [](double) {});
+}
+
+
+string to_string(const bigint &opr, int base)
+{
+    return to_string(opr, base, [](double) {});
+}
+
+
+template <typename Step>
+string to_string(const bigint &opr, int base, Step &&step)
+{
+    // log2(10) < 4, so four characters per decimal digit always suffice
+    string str(opr.digits.size() * 4 + 1, '\0');
+    std::to_chars_result result = bigint::toChars(str.data(), str.data() + str.size(), opr, base, step);
+    str.resize(size_t(result.ptr - str.data()));
+    return str;
+}
+
+
+string bigint_format_spec::apply(const bigint &opr) const
+{
+    int base = (type == 'b' || type == 'B') ? 2 : (type == 'o') ? 8 : (type == 'x' || type == 'X') ? 16 : 10;
+    string body = to_string(opr, base);
+    bool negative = (body[0] == '-');
+    if (negative)
+        body.erase(0, 1);
+    if (type == 'X')
+        std::transform(body.begin(), body.end(), body.begin(), [](char ch) { return char(std::toupper(ch)); });
+
+    string out = negative ? "-" : "";
+    if (alternate && base != 10 && !(base == 8 && body == "0"))
+        out += (base == 8) ? "0" : (base == 2) ? ((type == 'B') ? "0B" : "0b") : ((type == 'X') ? "0X" : "0x");
+
+    // Insert a separator before every full group, counting from the least significant digit
+    size_t group = (base == 10) ? 3 : 4;
+    for (size_t i = 0; i < body.size(); i++)
+    {
+        if (grouping && i && (body.size() - i) % group == 0)
+            out += grouping;
+        out += body[i];
+    }
+
+    if (out.size() >= width)
+        return out;
+    size_t pad = width - out.size();
+    if (align == '<')
+        return out + string(pad, fill);
+    if (align == '^')
+        return string(pad / 2, fill) + out + string(pad - pad / 2, fill);
+    return string(pad, fill) + out;
+}
+
+
+namespace bigint_expr
+{
+    /** @brief Leaf of an expression, referring to a bigint that must outlive the expression. */
+    struct leaf
+    {
+        const bigint &value;
+    };
+
+    /** @brief Negation of a subexpression. */
+    template <typename E>
+    struct negation
+    {
+        E operand;
+    };
+
+    /** @brief Sum (Sign = 1) or difference (Sign = -1) of two subexpressions. */
+    template <typename L, typename R, int Sign>
+    struct sum
+    {
+        L lhs;
+        R rhs;
+    };
+
+    /** @brief Product of two subexpressions. */
+    template <typename L, typename R>
+    struct product
+    {
+        L lhs;
+        R rhs;
+    };
+
+    template <>
+    struct is_expression<leaf> : std::true_type
+    {
+    };
+
+    template <typename E>
+    struct is_expression<negation<E>> : std::true_type
+    {
+    };
+
+    template <typename L, typename R, int Sign>
+    struct is_expression<sum<L, R, Sign>> : std::true_type
+    {
+    };
+
+    template <typename L, typename R>
+    struct is_expression<product<L, R>> : std::true_type
+    {
+    };
+
+    /** @brief True for the types that may appear as an operand of a lazy expression. */
+    template <typename T>
+    constexpr bool is_operand = is_expression<T>::value || std::is_same_v<T, bigint>;
+
+    /** @brief Wraps a bigint operand into a leaf, expressions are passed through. */
+    inline leaf as_node(const bigint &value) { return leaf{value}; }
+
+    template <typename E, typename = std::enable_if_t<is_expression<E>::value>>
+    const E &as_node(const E &expr) { return expr; }
+
+    /** @brief Node type of an operand. */
+    template <typename T>
+    using node_t = std::conditional_t<std::is_same_v<T, bigint>, leaf, T>;
+
+    /** @brief True if at least one operand is an expression, so plain bigint operands keep their eager operators. */
+    template <typename L, typename R>
+    constexpr bool is_lazy_pair = is_operand<L> && is_operand<R> && (is_expression<L>::value || is_expression<R>::value);
+
+    /**
+     * @brief Starts a lazy expression from a bigint.
+     * Expressions hold references to their operands, so they should be evaluated within the full expression
+     * that built them, e.g. x = lazy(a) * b + c - d;
+     * @param value The bigint to refer to.
+     * @return Leaf node referring to value.
+     */
+    inline leaf lazy(const bigint &value) { return leaf{value}; }
+
+    template <typename E, typename = std::enable_if_t<is_expression<E>::value>>
+    negation<E> operator-(const E &expr) { return {expr}; }
+
+    template <typename L, typename R, typename = std::enable_if_t<is_lazy_pair<L, R>>>
+    sum<node_t<L>, node_t<R>, 1> operator+(const L &lhs, const R &rhs) { return {as_node(lhs), as_node(rhs)}; }
+
+    template <typename L, typename R, typename = std::enable_if_t<is_lazy_pair<L, R>>>
+    sum<node_t<L>, node_t<R>, -1> operator-(const L &lhs, const R &rhs) { return {as_node(lhs), as_node(rhs)}; }
+
+    template <typename L, typename R, typename = std::enable_if_t<is_lazy_pair<L, R>>>
+    product<node_t<L>, node_t<R>> operator*(const L &lhs, const R &rhs) { return {as_node(lhs), as_node(rhs)}; }
+
+    /**
+     * @brief Evaluates an expression tree into a bigint.
+     * Every leaf and every product of two operands is accumulated into one vector of signed column sums,
+     * so a chain of additions and multiply-accumulates is a single carry-propagating sweep at the end.
+     * Products of two factors longer than bigint::karatsuba_threshold are multiplied with operator*= first.
+     * Products whose factors are themselves expressions evaluate those factors first.
+     */
+    struct evaluator
+    {
+        /** @brief Signed sum of digit contributions per decimal position. */
+        using columns = vector<int64_t>;
+
+        /** @brief Evaluates expr and stores the result in dest. dest may also appear in expr. */
+        template <typename E>
+        static void assign(bigint &dest, const E &expr)
+        {
+            columns acc;
+            collect(expr, 1, acc);
+            normalize(acc, dest);
+        }
+
+        static void collect(const leaf &node, int64_t sign, columns &acc)
+        {
+            const vector<uint8_t> &digits = node.value.digits;
+            if (acc.size() < digits.size())
+                acc.resize(digits.size(), 0);
+            sign *= node.value.sign;
+            for (size_t i = 0; i < digits.size(); i++)
+                acc[i] += sign * digits[i];
+        }
+
+        template <typename E>
+        static void collect(const negation<E> &node, int64_t sign, columns &acc)
+        {
+            collect(node.operand, -sign, acc);
+        }
+
+        template <typename L, typename R, int Sign>
+        static void collect(const sum<L, R, Sign> &node, int64_t sign, columns &acc)
+        {
+            collect(node.lhs, sign, acc);
+            collect(node.rhs, sign * Sign, acc);
+        }
+
+        template <typename L, typename R>
+        static void collect(const product<L, R> &node, int64_t sign, columns &acc)
+        {
+            const bigint &lhs = factor(node.lhs);
+            const bigint &rhs = factor(node.rhs);
+            const vector<uint8_t> &digits_l = lhs.digits;
+            const vector<uint8_t> &digits_r = rhs.digits;
+            if (std::min(digits_l.size(), digits_r.size()) > bigint::karatsuba_threshold)
+            {
+                // Long factors: Karatsuba in operator*= beats the schoolbook accumulation, add its digits instead.
+                bigint result = lhs;
+                result *= rhs;
+                collect(leaf{result}, sign, acc);
+                return;
+            }
+            if (acc.size() < digits_l.size() + digits_r.size())
+                acc.resize(digits_l.size() + digits_r.size(), 0);
+            sign *= lhs.sign * rhs.sign;
+            // Multiply-accumulate: partial products go straight into their columns, carries are deferred.
+            for (size_t i = 0; i < digits_l.size(); i++)
+            {
+                int64_t scaled = sign * digits_l[i];
+                if (!scaled)
+                    continue;
+                int64_t *column = acc.data() + i;
+                for (size_t j = 0; j < digits_r.size(); j++)
+                    column[j] += scaled * digits_r[j];
+            }
+        }
+
+        static const bigint &factor(const leaf &node) { return node.value; }
+
+        template <typename E>
+        static bigint factor(const E &expr)
+        {
+            bigint result;
+            assign(result, expr);
+            return result;
+        }
+
+        /** @brief Propagates the carries of acc and writes the resulting digits and sign into dest. */
+        static void normalize(columns &acc, bigint &dest)
+        {
+            int8_t sign = 1;
+            int64_t carry = propagate(acc);
+            if (carry < 0)
+            {
+                // The value is negative: negate every column, the carry becomes the top column, and propagate again.
+                for (int64_t &column : acc)
+                    column = -column;
+                acc.push_back(-carry);
+                carry = propagate(acc);
+                sign = -1;
+            }
+            for (; carry; carry /= 10)
+                acc.push_back(carry % 10);
+
+            vector<uint8_t> &digits = dest.digits.edit();
+            digits.resize(acc.size());
+            for (size_t i = 0; i < acc.size(); i++)
+                digits[i] = uint8_t(acc[i]);
+            if (digits.empty())
+                digits.push_back(0);
+            dest.removeZeroAtStart();
+            // 0 always has sign value 1 (invariant)
+            dest.setSign(dest.digits.back() == 0 ? 1 : sign);
+        }
+
+        /** @brief Brings every column into [0, 9] using floor division. @return The carry out of the top column. */
+        static int64_t propagate(columns &acc)
+        {
+            int64_t carry = 0;
+            for (int64_t &column : acc)
+            {
+                int64_t value = column + carry;
+                int64_t digit = value % 10;
+                carry = value / 10;
+                if (digit < 0)
+                {
+                    digit += 10;
+                    carry--;
+                }
+                column = digit;
+            }
+            return carry;
+        }
+    };
+}
+
+
+template <typename E, typename>
+bigint::bigint(const E &expr)
+{
+    bigint_expr::evaluator::assign(*this, expr);
+}
+
+
+template <typename E, typename>
+bigint &bigint::operator=(const E &expr)
+{
+    bigint_expr::evaluator::assign(*this, expr);
+    return *this;
+}
+
+
+/**
+ * @brief Compile-time counterpart of bigint with a fixed capacity of N decimal digits.
+ * Every operation is constexpr, so constant tables and _big literals are evaluated by the compiler
+ * and placed in read-only data. Converting to bigint copies the digits without parsing.
+ * Results that need more than N digits throw std::overflow_error, which is a compile error in constant evaluation.
+ * @tparam N Maximum number of decimal digits.
+ */
+template <size_t N>
+struct static_bigint
+{
+    static_assert(N > 0, "static_bigint needs room for at least one digit");
+
+    /** @brief Digits in base 10, least significant first as in bigint. Digits at and above length are zero. */
+    std::array<uint8_t, N> digits{};
+
+    /** @brief Number of used digits, 1 for zero. */
+    size_t length = 1;
+
+    /** @brief Sign, 1 for positive, -1 for negative. 0 always has sign 1. */
+    int8_t sign = 1;
+
+    /** @brief Constructs a static_bigint initialized to zero. */
+    constexpr static_bigint() = default;
+
+    /** @brief Constructs a static_bigint from an int64_t.
+     *  @param number The int64_t value to initialize from.
+     */
+    constexpr static_bigint(int64_t number)
+    {
+        sign = (number >= 0) ? 1 : -1;
+        length = 0;
+        do
+        {
+            if (length == N)
+                throw std::overflow_error("Value does not fit in static_bigint!");
+            digits[length++] = uint8_t(sign * (number % 10));
+            number /= 10;
+        } while (number);
+    }
+
+    /** @brief Constructs a static_bigint from a string, with the same rules as bigint(const string &).
+     *  Digit separators (') are skipped so that literals may use them.
+     *  @param str The string to initialize from.
+     */
+    constexpr explicit static_bigint(std::string_view str)
+    {
+        if (str.empty() || str == "0")
+            return;
+        size_t i = 0;
+        if (str[0] == '-')
+        {
+            sign = -1;
+            i++;
+        }
+        if (i == str.size() || str[i] == '0')
+            throw invalid_argument("Initializing string should not start with zero!");
+        length = 0;
+        for (size_t j = str.size(); j > i; j--)
+        {
+            char ch = str[j - 1];
+            if (ch == '\'')
+                continue;
+            if (ch < '0' || ch > '9')
+                throw invalid_argument("Initializing string should contain digits only!");
+            if (length == N)
+                throw std::overflow_error("Value does not fit in static_bigint!");
+            digits[length++] = uint8_t(ch - '0');
+        }
+    }
+
+    /** @brief Converts from a static_bigint of another capacity.
+     *  @param rhs The static_bigint to convert from, must fit in N digits.
+     */
+    template <size_t M>
+    constexpr static_bigint(const static_bigint<M> &rhs) : length(rhs.length), sign(rhs.sign)
+    {
+        if (rhs.length > N)
+            throw std::overflow_error("Value does not fit in static_bigint!");
+        for (size_t i = 0; i < rhs.length; i++)
+            digits[i] = rhs.digits[i];
+    }
+
+    /** @brief Converts to a dynamically sized bigint by copying the digits.
+     *  @return The equivalent bigint.
+     */
+    operator bigint() const
+    {
+        bigint result;
+        result.digits.assign(digits.begin(), digits.begin() + std::ptrdiff_t(length));
+        result.sign = sign;
+        return result;
+    }
+
+    /** @brief Negates a static_bigint.
+     *  @return The negated value.
+     */
+    constexpr static_bigint operator-() const
+    {
+        static_bigint result = *this;
+        if (!isZero())
+            result.sign = int8_t(-sign);
+        return result;
+    }
+
+    /** @brief Adds a static_bigint to the current one. */
+    constexpr static_bigint &operator+=(const static_bigint &rhs)
+    {
+        if (sign == rhs.sign)
+            addMagnitude(rhs);
+        else if (compareMagnitude(rhs) >= 0)
+            subtractMagnitude(rhs);
+        else
+        {
+            // |rhs| is larger: the result is |rhs| - |this| with the sign of rhs
+            static_bigint temp = rhs;
+            temp.subtractMagnitude(*this);
+            *this = temp;
+        }
+        if (isZero())
+            sign = 1;
+        return *this;
+    }
+
+    /** @brief Subtracts a static_bigint from the current one. */
+    constexpr static_bigint &operator-=(const static_bigint &rhs)
+    {
+        return *this += -rhs;
+    }
+
+    /** @brief Multiplies the current static_bigint with another one. */
+    constexpr static_bigint &operator*=(const static_bigint &rhs)
+    {
+        if (isZero() || rhs.isZero())
+            return *this = static_bigint();
+        if (length + rhs.length - 1 > N)
+            throw std::overflow_error("Value does not fit in static_bigint!");
+        // Accumulate all partial products per column, then propagate the carries once
+        std::array<uint64_t, N> columns{};
+        for (size_t i = 0; i < length; i++)
+            for (size_t j = 0; j < rhs.length; j++)
+                columns[i + j] += uint64_t(digits[i]) * rhs.digits[j];
+        uint64_t carry = 0;
+        for (size_t i = 0; i < N; i++)
+        {
+            uint64_t value = columns[i] + carry;
+            digits[i] = uint8_t(value % 10);
+            carry = value / 10;
+            if (digits[i])
+                length = i + 1;
+        }
+        if (carry)
+            throw std::overflow_error("Value does not fit in static_bigint!");
+        sign = int8_t(sign * rhs.sign);
+        return *this;
+    }
+
+    constexpr static_bigint operator+(const static_bigint &rhs) const { return static_bigint(*this) += rhs; }
+    constexpr static_bigint operator-(const static_bigint &rhs) const { return static_bigint(*this) -= rhs; }
+    constexpr static_bigint operator*(const static_bigint &rhs) const { return static_bigint(*this) *= rhs; }
+
+    friend constexpr bool operator==(const static_bigint &lhs, const static_bigint &rhs)
+    {
+        return lhs.sign == rhs.sign && lhs.compareMagnitude(rhs) == 0;
+    }
+
+    friend constexpr bool operator<(const static_bigint &lhs, const static_bigint &rhs)
+    {
+        if (lhs.sign != rhs.sign)
+            return lhs.sign < rhs.sign;
+        int cmp = lhs.compareMagnitude(rhs);
+        return (lhs.sign == 1) ? cmp < 0 : cmp > 0;
+    }
+
+private:
+    constexpr bool isZero() const { return length == 1 && digits[0] == 0; }
+
+    /** @brief Compares absolute values. @return Negative, zero or positive like strcmp. */
+    constexpr int compareMagnitude(const static_bigint &rhs) const
+    {
+        if (length != rhs.length)
+            return (length < rhs.length) ? -1 : 1;
+        for (size_t i = length; i > 0; i--)
+            if (digits[i - 1] != rhs.digits[i - 1])
+                return (digits[i - 1] < rhs.digits[i - 1]) ? -1 : 1;
+        return 0;
+    }
+
+    /** @brief Adds |rhs| to the magnitude. */
+    constexpr void addMagnitude(const static_bigint &rhs)
+    {
+        size_t len = std::max(length, rhs.length);
+        uint8_t carry = 0;
+        for (size_t i = 0; i < len; i++)
+        {
+            uint8_t sum_new = uint8_t(digits[i] + rhs.digits[i] + carry);
+            digits[i] = sum_new % 10;
+            carry = (sum_new >= 10);
+        }
+        length = len;
+        if (carry)
+        {
+            if (length == N)
+                throw std::overflow_error("Value does not fit in static_bigint!");
+            digits[length++] = 1;
+        }
+    }
+
+    /** @brief Subtracts |rhs| from the magnitude, assuming |this| >= |rhs|. */
+    constexpr void subtractMagnitude(const static_bigint &rhs)
+    {
+        uint8_t borrow = 0;
+        for (size_t i = 0; i < length; i++)
+        {
+            uint8_t sum_new = uint8_t(digits[i] + 10 - rhs.digits[i] - borrow);
+            digits[i] = sum_new % 10;
+            borrow = (sum_new < 10);
+        }
+        while (length > 1 && digits[length - 1] == 0)
+            length--;
+    }
+};
+
+
+/**
+ * @brief Literal operator for compile-time bigint constants, e.g. 123456789012345678901234567890_big.
+ * The value is a static_bigint sized to the literal and converts implicitly to bigint.
+ * @return The static_bigint holding the literal value.
+ */
+template <char... Chars>
+consteval static_bigint<sizeof...(Chars)> operator""_big()
+{
+    constexpr char str[] = {Chars...};
+    return static_bigint<sizeof...(Chars)>(std::string_view(str, sizeof...(Chars)));
+}
+
+
+uint64_t bigint_hash::absorb(uint64_t h, uint64_t word)
+{
+    word *= 0x87c37b91114253d5ull;
+    word = std::rotl(word, 31);
+    return (h ^ word) * 0x9e3779b97f4a7c15ull + 0x52dce729;
+}
+
+
+size_t bigint_hash::finish(uint64_t digest, bool negative)
+{
+    // murmur3 finalizer
+    uint64_t h = digest ^ (negative ? 0xa5a5a5a5a5a5a5a5ull : 0);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return size_t(h);
+}
+
+
+uint64_t bigint_hash::byteSwap(uint64_t word)
+{
+#if defined(__cpp_lib_byteswap)
+    return std::byteswap(word);
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(word);
+#else
+    // Swap bytes, then 16-bit halves, then 32-bit halves
+    word = ((word & 0x00ff00ff00ff00ffull) << 8) | ((word >> 8) & 0x00ff00ff00ff00ffull);
+    word = ((word & 0x0000ffff0000ffffull) << 16) | ((word >> 16) & 0x0000ffff0000ffffull);
+    return (word << 32) | (word >> 32);
+#endif
+}
+
+
+uint64_t bigint_hash::digestDigits(const vector<uint8_t> &digits)
+{
     size_t len = digits.size();
+    uint64_t h = len;
+    size_t i = len;
+    // Full words from the most significant end; the byte order is reversed so the
+    // first byte of the word is the most significant digit, as in digestText.
+    for (; i >= 8; i -= 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, digits.data() + i - 8, 8);
+        if constexpr (std::endian::native == std::endian::little)
+            word = byteSwap(word);
+        h = absorb(h, word);
+    }
+    if (i)
+    {
+        uint64_t word = 0;
+        for (size_t k = 0; k < i; k++)
+            word |= uint64_t(digits[i - 1 - k]) << (8 * k);
+        h = absorb(h, word);
+    }
+    return h;
+}
 
-    // Outputting each digit starting from the most significant one
-    for (int64_t i = int64_t(len - 1); i >= 0; i--)
-        out << static_cast<int64_t>(digits[uint8_t(i)]);
 
-    // out << '\n'; // Newline after printing the bigint
-    return out;
+uint64_t bigint_hash::digestText(std::string_view text)
+{
+    size_t len = text.size();
+    uint64_t h = len;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, text.data() + i, 8);
+        if constexpr (std::endian::native == std::endian::big)
+            word = byteSwap(word);
+        // '0'..'9' to 0..9 in every byte at once, no byte borrows for digit characters
+        h = absorb(h, word - 0x3030303030303030ull);
+    }
+    if (i < len)
+    {
+        uint64_t word = 0;
+        for (size_t k = 0; i + k < len; k++)
+            word |= uint64_t(uint8_t(text[i + k] - '0')) << (8 * k);
+        h = absorb(h, word);
+    }
+    return h;
+}
+
+
+size_t bigint_hash::operator()(const bigint &opr) const
+{
+#ifdef BIGINT_CACHE_HASH
+    uint64_t digest = opr.digits.getCachedHash();
+    if (!digest)
+    {
+        // 0 marks an empty cache, so a real digest of 0 is stored as 1
+        digest = std::max<uint64_t>(digestDigits(opr.digits), 1);
+        opr.digits.setCachedHash(size_t(digest));
+    }
+#else
+    uint64_t digest = std::max<uint64_t>(digestDigits(opr.digits), 1);
+#endif
+    return finish(digest, opr.sign == -1);
+}
+
+
+size_t bigint_hash::operator()(int64_t number) const
+{
+    char buf[20];
+    uint64_t magnitude = (number < 0) ? 0 - uint64_t(number) : uint64_t(number);
+    std::to_chars_result res = std::to_chars(buf, buf + sizeof(buf), magnitude);
+    return finish(std::max<uint64_t>(digestText(std::string_view(buf, size_t(res.ptr - buf))), 1), number < 0);
 }
+
+
+size_t bigint_hash::operator()(std::string_view str) const
+{
+    bool negative = !str.empty() && str[0] == '-';
+    if (negative)
+        str.remove_prefix(1);
+    // the empty string initializes to zero
+    return finish(std::max<uint64_t>(digestText(str.empty() ? "0" : str), 1), negative);
+}
+
+
+bool bigint_equal::operator()(const bigint &lhs, const bigint &rhs) const
+{
+    return lhs == rhs;
+}
+
+
+bool bigint_equal::operator()(const bigint &lhs, int64_t rhs) const
+{
+    if (lhs.sign != ((rhs >= 0) ? 1 : -1))
+        return false;
+    const vector<uint8_t> &digits = lhs.digits;
+    uint64_t magnitude = (rhs < 0) ? 0 - uint64_t(rhs) : uint64_t(rhs);
+    // Compare digit by digit, least significant first; zero is the single digit 0
+    size_t i = 0;
+    do
+    {
+        if (i == digits.size() || digits[i] != magnitude % 10)
+            return false;
+        magnitude /= 10;
+        i++;
+    } while (magnitude);
+    return i == digits.size();
+}
+
+
+bool bigint_equal::operator()(const bigint &lhs, std::string_view rhs) const
+{
+    if (rhs.empty())
+        rhs = "0";
+    int8_t sign = 1;
+    if (rhs[0] == '-')
+    {
+        sign = -1;
+        rhs.remove_prefix(1);
+    }
+    const vector<uint8_t> &digits = lhs.digits;
+    if (lhs.sign != sign || rhs.size() != digits.size())
+        return false;
+    // The string holds the most significant digit first, the bigint stores it last
+    for (size_t i = 0; i < rhs.size(); i++)
+        if (rhs[i] - '0' != digits[rhs.size() - 1 - i])
+            return false;
+    return true;
+}
+
+
+#ifdef __cpp_lib_format
+/** @brief std::format support for bigint, see bigint_format_spec for the accepted options. */
+template <>
+struct std::formatter<bigint, char>
+{
+    bigint_format_spec spec;
+
+    constexpr std::format_parse_context::iterator parse(std::format_parse_context &ctx)
+    {
+        const char *first = std::to_address(ctx.begin());
+        const char *end = spec.parse(first, std::to_address(ctx.end()));
+        if (!end)
+            throw std::format_error("Invalid format spec for bigint!");
+        return ctx.begin() + (end - first);
+    }
+
+    template <typename FormatContext>
+    typename FormatContext::iterator format(const bigint &opr, FormatContext &ctx) const
+    {
+        string str = spec.apply(opr);
+        return std::copy(str.begin(), str.end(), ctx.out());
+    }
+};
+#endif
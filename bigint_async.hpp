@@ -0,0 +1,327 @@
+/**
+ * @file bigint_async.hpp
+ * @author {Eva Wu} ({gudautd@gmail.com})
+ * @brief Header file and implementation of cancellable asynchronous bigint operations
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+#pragma once
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include "bigint.hpp"
+
+/**
+ * @brief Asynchronous variants of long-running bigint operations.
+ * The work is split into blocks of digits; between blocks it reports progress and stops early
+ * if cancellation was requested or the deadline has passed, failing the future with operation_cancelled.
+ */
+namespace bigint_async
+{
+    /** @brief Exception stored in the future of an operation that was cancelled or ran past its deadline. */
+    class operation_cancelled : public std::runtime_error
+    {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    /** @brief Cancellation and progress settings of one operation. */
+    struct options
+    {
+        /** @brief Stops the operation at the next block boundary once a stop is requested. */
+        std::stop_token stop;
+
+        /** @brief Stops the operation at the next block boundary once this time has passed. */
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+
+        /** @brief Called from the worker with the completed fraction in [0, 1] at every block boundary. */
+        std::function<void(double)> progress;
+    };
+
+    /** @brief Block boundary handed to the work of an operation: reports progress and throws if it should stop. */
+    class checkpoint
+    {
+    private:
+        const options &opts;
+
+    public:
+        explicit checkpoint(const options &new_opts) : opts(new_opts) {}
+
+        /** @brief Marks a block boundary.
+         *  @param fraction The completed fraction of the work.
+         */
+        void operator()(double fraction) const
+        {
+            if (opts.stop.stop_requested())
+                throw operation_cancelled("Operation cancelled!");
+            if (std::chrono::steady_clock::now() > opts.deadline)
+                throw operation_cancelled("Operation deadline exceeded!");
+            if (opts.progress)
+                opts.progress(fraction);
+        }
+    };
+
+    /** @brief Promise of a submitted operation that fails with operation_cancelled if its task is destroyed unrun. */
+    template <typename T>
+    struct pending
+    {
+        std::promise<T> promise;
+        bool started = false;
+
+        ~pending()
+        {
+            if (started)
+                return;
+            try
+            {
+                promise.set_exception(std::make_exception_ptr(operation_cancelled("Operation dropped by its executor!")));
+            }
+            catch (...)
+            {
+                // nobody can observe the failure: the promise is destroyed next and reports broken_promise
+            }
+        }
+    };
+
+    /** @brief An executor is any callable that runs a std::function<void()>, now or later, on some thread. */
+    template <typename E>
+    concept executor = std::invocable<E &, std::function<void()>>;
+
+    /** @brief Fixed-size pool of worker threads running tasks in submission order. */
+    class thread_pool
+    {
+    private:
+        std::mutex mutex;
+        std::condition_variable_any ready;
+        std::deque<std::function<void()>> tasks;
+        vector<std::jthread> workers;
+
+        void work(std::stop_token stop)
+        {
+            while (true)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    if (!ready.wait(lock, stop, [this] { return !tasks.empty(); }) || stop.stop_requested())
+                        return; // stop requested by the destructor; the queue is left to it
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+    public:
+        /** @brief Starts the worker threads.
+         *  @param threads Number of workers, the hardware concurrency by default.
+         */
+        explicit thread_pool(size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+        {
+            for (size_t i = 0; i < threads; i++)
+                workers.emplace_back([this](std::stop_token stop) { work(stop); });
+        }
+
+        /**
+         * @brief Stops the workers after their current task and drops the tasks still queued.
+         * Operations queued through submit then fail with operation_cancelled.
+         */
+        ~thread_pool()
+        {
+            for (std::jthread &worker : workers)
+                worker.request_stop();
+            for (std::jthread &worker : workers)
+                worker.join();
+            tasks.clear();
+        }
+
+        /** @brief Queues a task.
+         *  @param task The task to run on a worker.
+         */
+        void operator()(std::function<void()> task)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                tasks.push_back(std::move(task));
+            }
+            ready.notify_one();
+        }
+
+        /** @brief Gets the library's shared pool, started on first use.
+         *  @return The shared thread_pool.
+         */
+        static thread_pool &shared()
+        {
+            static thread_pool pool;
+            return pool;
+        }
+    };
+
+    /**
+     * @brief Runs work(checkpoint) on an executor.
+     * @param exec The executor to run on.
+     * @param opts Cancellation and progress settings.
+     * @param work Callable taking a const checkpoint & and returning the result, such as a bigint.
+     * @return Future of the result; it holds operation_cancelled if the work stopped early,
+     *         or if the executor destroyed the task without running it.
+     */
+    template <executor Executor, typename F>
+    auto submit(Executor &&exec, options opts, F work)
+    {
+        using result_type = std::invoke_result_t<F &, const checkpoint &>;
+        auto state = std::make_shared<pending<result_type>>();
+        std::future<result_type> result = state->promise.get_future();
+        exec(std::function<void()>([state, opts = std::move(opts), work = std::move(work)]() {
+            state->started = true;
+            try
+            {
+                checkpoint check(opts);
+                check(0.0); // the operation may have been cancelled while queued
+                state->promise.set_value(work(check));
+            }
+            catch (...)
+            {
+                state->promise.set_exception(std::current_exception());
+            }
+        }));
+        return result;
+    }
+
+    /**
+     * @brief Multiplies two bigint numbers on an executor.
+     * The multiplication is the one operator*= performs; the checkpoint is passed at every Karatsuba
+     * recursion step above bigint's threshold, and every 1024 rows of a schoolbook product.
+     * @param lhs The left-hand side bigint.
+     * @param rhs The right-hand side bigint.
+     * @param exec The executor to run on.
+     * @param opts Cancellation and progress settings.
+     * @return Future of the product of lhs and rhs.
+     */
+    template <executor Executor>
+    std::future<bigint> multiply(bigint lhs, bigint rhs, Executor &&exec, options opts = {})
+    {
+        return submit(exec, std::move(opts), [lhs = std::move(lhs), rhs = std::move(rhs)](const checkpoint &check) {
+            bigint product = lhs;
+            product.multiply(rhs, check);
+            check(1.0);
+            return product;
+        });
+    }
+
+    /**
+     * @brief Multiplies two bigint numbers on the library's shared thread pool.
+     * @param lhs The left-hand side bigint.
+     * @param rhs The right-hand side bigint.
+     * @param opts Cancellation and progress settings.
+     * @return Future of the product of lhs and rhs.
+     */
+    inline std::future<bigint> multiply(bigint lhs, bigint rhs, options opts = {})
+    {
+        return multiply(std::move(lhs), std::move(rhs), thread_pool::shared(), std::move(opts));
+    }
+
+    /**
+     * @brief Divides one bigint by another on an executor, truncating toward zero.
+     * The dividend is processed in blocks of digits, most significant first: the running remainder is
+     * shifted up by one block, the block is added, and the quotient block is split off, with a checkpoint
+     * after every block.
+     * @param lhs The dividend.
+     * @param rhs The divisor, must not be zero.
+     * @param exec The executor to run on.
+     * @param opts Cancellation and progress settings.
+     * @return Future of the quotient of lhs and rhs; it holds invalid_argument if rhs is zero.
+     */
+    template <executor Executor>
+    std::future<bigint> divide(bigint lhs, bigint rhs, Executor &&exec, options opts = {})
+    {
+        return submit(exec, std::move(opts), [lhs = std::move(lhs), rhs = std::move(rhs)](const checkpoint &check) {
+            if (rhs == bigint(0))
+                throw invalid_argument("Division by zero!");
+            int8_t sign = int8_t(lhs.getSign() * rhs.getSign());
+            bigint rest = lhs;
+            bigint divisor = rhs;
+            if (rest.getSign() == -1)
+                rest.negate();
+            if (divisor.getSign() == -1)
+                divisor.negate();
+            // Blocks at least as long as the divisor keep each step's long division linear in the block
+            size_t block = std::max({size_t(64), divisor.getDigitCount(), (rest.getDigitCount() + 255) / 256});
+
+            vector<bigint> blocks; // least significant first
+            while (rest != bigint(0))
+                blocks.push_back(rest.divmodPow10(block));
+
+            bigint quotient;
+            bigint remainder;
+            for (size_t i = blocks.size(); i > 0; i--)
+            {
+                remainder.mulPow10(block);
+                remainder += blocks[i - 1];
+                bigint quotient_block = remainder;
+                remainder = quotient_block.divmod(divisor);
+                quotient.mulPow10(block);
+                quotient += quotient_block;
+                check(double(blocks.size() - i + 1) / double(blocks.size()));
+            }
+            if (sign == -1)
+                quotient.negate();
+            return quotient;
+        });
+    }
+
+    /**
+     * @brief Divides one bigint by another on the library's shared thread pool, truncating toward zero.
+     * @param lhs The dividend.
+     * @param rhs The divisor, must not be zero.
+     * @param opts Cancellation and progress settings.
+     * @return Future of the quotient of lhs and rhs.
+     */
+    inline std::future<bigint> divide(bigint lhs, bigint rhs, options opts = {})
+    {
+        return divide(std::move(lhs), std::move(rhs), thread_pool::shared(), std::move(opts));
+    }
+
+    /**
+     * @brief Converts a bigint to a string in the given base on an executor.
+     * Base 10 is a copy of the digits. Other bases convert the decimal digits to binary words and, for bases
+     * that are not powers of two, the words to output digits; both are quadratic and pass a checkpoint
+     * every few thousand digits.
+     * @param opr The bigint to convert.
+     * @param base The base to convert to, between 2 and 36.
+     * @param exec The executor to run on.
+     * @param opts Cancellation and progress settings.
+     * @return Future of the string representation; it holds invalid_argument if base is out of range.
+     */
+    template <executor Executor>
+    std::future<string> to_string(bigint opr, int base, Executor &&exec, options opts = {})
+    {
+        return submit(exec, std::move(opts), [opr = std::move(opr), base](const checkpoint &check) {
+            string str = ::to_string(opr, base, check);
+            check(1.0);
+            return str;
+        });
+    }
+
+    /**
+     * @brief Converts a bigint to a string in the given base on the library's shared thread pool.
+     * @param opr The bigint to convert.
+     * @param base The base to convert to, between 2 and 36.
+     * @param opts Cancellation and progress settings.
+     * @return Future of the string representation.
+     */
+    inline std::future<string> to_string(bigint opr, int base = 10, options opts = {})
+    {
+        return to_string(std::move(opr), base, thread_pool::shared(), std::move(opts));
+    }
+}
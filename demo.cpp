@@ -10,7 +10,13 @@
  */
 #include <iostream>
 #include <cassert>
+#include <sstream>
+#include <unordered_map>
 #include "bigint.hpp"
+#include "fixed_int.hpp"
+#include "bigdecimal.hpp"
+#include "product_tree.hpp"
+#include "bigint_async.hpp"
 
 using std::cout;
 
@@ -91,6 +97,43 @@ void testAssignment() {
 }
 
 
+void testCopiesAreIndependent() {
+    // Holds with and without BIGINT_COPY_ON_WRITE: mutation detaches shared digits
+    bigint a("123456789012345678901234567890");
+    bigint b = a;
+    bigint c = -a;
+    b += bigint(1);
+    c *= bigint(2);
+    assert(a == bigint("123456789012345678901234567890"));
+    assert(b == bigint("123456789012345678901234567891"));
+    assert(c == bigint("-246913578024691357802469135780"));
+    bigint d = std::move(b);
+    d = d;
+    assert(d == bigint("123456789012345678901234567891"));
+    a += a;
+    assert(a == bigint("246913578024691357802469135780"));
+}
+
+void testMovedFrom() {
+    // A moved-from bigint is zero and stays usable
+    bigint a("-98765432109876543210");
+    bigint b = std::move(a);
+    assert(b == bigint("-98765432109876543210"));
+    assert(a == bigint(0) && to_string(a) == "0");
+    assert(a.getDigitCount() == 1 && bigint_hash()(a) == bigint_hash()(bigint(0)));
+    static_assert(std::is_nothrow_move_constructible_v<bigint> && std::is_nothrow_move_assignable_v<bigint>);
+    assert(-a == bigint(0));
+    a *= bigint(7);
+    a += bigint(3);
+    assert(a == bigint(3));
+
+    bigint c;
+    c = std::move(b);
+    assert(c == bigint("-98765432109876543210") && b == bigint(0));
+    b -= bigint(1);
+    assert(b == bigint(-1));
+}
+
 void testEquality() {
     bigint a("12345");
     bigint b("12345");
@@ -119,6 +162,41 @@ void testLargeNumbers() {
     assert(a - b == bigint("99999999999999999999999999999998"));
 }
 
+void testLongOperands() {
+    // Long enough for Karatsuba multiplication and recursive division
+    bigint nines(string(300, '9')); // 10^300 - 1
+    bigint square = nines * nines;  // 10^600 - 2 * 10^300 + 1
+    assert(square == bigint(string(299, '9') + "8" + string(299, '0') + "1"));
+    assert(square / nines == nines && square % nines == bigint(0));
+
+    bigint a(string(250, '7') + string(250, '3'));
+    bigint b("-" + string(170, '2') + "1" + string(40, '5'));
+    bigint q = a;
+    bigint r = q.divmod(b);
+    assert(q * b + r == a && r.getSign() == 1 && -r > b);
+    assert(a * b == b * a && (a * b) / a == b);
+}
+
+void testSignOfValuesEndingInZero() {
+    // zero is detected by the most significant digit, not the last one
+    bigint a("-120");
+    assert(-a == bigint("120") && (-a).getSign() == 1);
+    assert(a + bigint(30) == bigint("-90"));
+    assert(bigint(10) - bigint(100) == bigint("-90"));
+    assert(bigint(50) + bigint(-50) == bigint(0) && (bigint(50) + bigint(-50)).getSign() == 1);
+}
+
+void testLongComparison() {
+    // digits are indexed past 256
+    string digits(300, '1');
+    bigint a(digits);
+    bigint b("2" + digits.substr(1));
+    assert(a < b && a <= b && b > a && !(b < a));
+    assert(-b < -a && -b <= -a);
+    assert(a <= a && !(a < a));
+    assert(b - a == bigint("1" + string(299, '0')));
+}
+
 void testLeadingZeros() {
     try{
         bigint a("00012345");
@@ -140,21 +218,410 @@ void testInvalidString() {
     }
 }
 
+void testToChars() {
+    char buf[64];
+    bigint a("-255");
+    auto res = to_chars(buf, buf + sizeof(buf), a, 16);
+    assert(res.ec == std::errc() && string(buf, res.ptr) == "-ff");
+    res = to_chars(buf, buf + 3, a);
+    assert(res.ec == std::errc::value_too_large);
+    res = to_chars(buf, buf + 4, a);
+    assert(res.ec == std::errc() && string(buf, res.ptr) == "-255");
+
+    bigint b("340282366920938463463374607431768211455"); // 2^128 - 1
+    assert(to_string(b, 16) == string(32, 'f'));
+    assert(to_string(b, 2) == string(128, '1'));
+    assert(to_string(b + bigint(1), 8) == "4" + string(42, '0'));
+    assert(to_string(bigint("1000000000000000000000"), 3) == "100010202110111202020110202012022202010121001");
+    assert(to_string(bigint(0), 2) == "0");
+    assert(to_string(bigint(35), 36) == "z");
+}
+
+void testFormatSpec() {
+    bigint_format_spec spec;
+    string fmt = "*^#12_x}";
+    assert(spec.parse(fmt.data(), fmt.data() + fmt.size()) == fmt.data() + fmt.size() - 1);
+    assert(spec.apply(bigint(-3054092982)) == "-0xb609_c2b6");
+    spec.width = 16;
+    assert(spec.apply(bigint(255)) == "******0xff******");
+
+    bigint_format_spec grouped;
+    fmt = ",}";
+    grouped.parse(fmt.data(), fmt.data() + fmt.size());
+    assert(grouped.apply(bigint("-1234567")) == "-1,234,567");
+    assert(grouped.apply(bigint(123)) == "123");
+
+    bigint_format_spec invalid;
+    fmt = "q}";
+    assert(invalid.parse(fmt.data(), fmt.data() + fmt.size()) == nullptr);
+
+    std::ostringstream out;
+    out << std::hex << std::uppercase << bigint(-48879);
+    assert(out.str() == "-BEEF");
+
+#ifdef __cpp_lib_format
+    assert(std::format("{}", bigint("-98765432109876543210")) == "-98765432109876543210");
+    assert(std::format("{:,}", bigint(1234567)) == "1,234,567");
+    assert(std::format("{:*^#12_x}", bigint(-3054092982)) == "-0xb609_c2b6");
+    assert(std::format("[{:>6}]", bigint(42)) == "[    42]");
+#endif
+}
+
+void testLazyExpressions() {
+    using bigint_expr::lazy;
+    bigint a("99999999999999999999");
+    bigint b("-123456789012345678901234567890");
+    bigint c("7");
+    bigint d("-100000000000000000000");
+
+    bigint long_a(string(200, '8') + "1"), long_b("-" + string(150, '3') + "7");
+    bigint total = long_a;
+    total = lazy(long_a) * long_b + total - lazy(b) * long_a;
+    assert(total == long_a * long_b + long_a - b * long_a);
+
+    bigint x = lazy(a) + b - c + d;
+    assert(x == a + b - c + d);
+    x = lazy(a) * b + c;
+    assert(x == a * b + c);
+    x = lazy(x) - a * b - c;  // destination may appear in its own expression
+    assert(x == bigint(0) && x.getSign() == 1);
+    x = -(lazy(a) - b) * (lazy(c) + d) - b * d;
+    assert(x == -(a - b) * (c + d) - b * d);
+    x = lazy(d) + a + bigint(1);
+    assert(x == bigint(0));
+}
+
+/* compile-time table of powers of ten */
+constexpr std::array<static_bigint<40>, 40> pow10_table = [] {
+    std::array<static_bigint<40>, 40> table{};
+    table[0] = 1;
+    for (size_t i = 1; i < table.size(); i++)
+        table[i] = table[i - 1] * 10;
+    return table;
+}();
+
+void testStaticBigint() {
+    constexpr auto a = 123456789012345678901234567890_big;
+    constexpr static_bigint<30> b = -a + 1'000_big;
+    static_assert(b == static_bigint<30>("-123456789012345678901234566890"));
+    static_assert(static_bigint<40>(a) * pow10_table[9] == static_bigint<40>("123456789012345678901234567890000000000"));
+    static_assert(static_bigint<4>(-12) < static_bigint<4>(3) && pow10_table[2] - 101 == -1);
+
+    bigint c = a;
+    assert(c == bigint("123456789012345678901234567890"));
+    assert(bigint(b) == c * bigint(-1) + bigint(1000));
+    assert(bigint(pow10_table[39]) == bigint("1000000000000000000000000000000000000000"));
+    assert(bigint(static_bigint<1>()) == bigint(0));
+}
+
+void testFixedInt() {
+    using u256 = uint_t<256>;
+    using i128 = int_t<128>;
+    using checked_i128 = int_t<128, overflow_mode::checked>;
+
+    bigint a("115792089237316195423570985008687907853269984665640564039457584007913129639935"); // 2^256 - 1
+    u256 max(a);
+    assert(bigint(max) == a);
+    assert(max + u256(1) == u256(0)); // wraps around
+    assert(bigint(max * max) == bigint(1));
+    static_assert(u256(0) - u256(1) == u256(-1));
+
+    bigint b("-85070591730234615865843651857942052864"); // -2^126
+    i128 c(b);
+    assert(bigint(c) == b);
+    assert(c * i128(-3) == c); // 3 * 2^126 wraps to -2^126
+    assert(bigint(c * i128(3)) == bigint("85070591730234615865843651857942052864")); // wraps to 2^126
+    assert(c < i128(0) && i128(5) > c && -c == i128(bigint("85070591730234615865843651857942052864")));
+
+    checked_i128 d(b);
+    assert(bigint(d + d) == b * bigint(2)); // -2^127 still fits
+    assert(bigint(d * checked_i128(-1)) == -b);
+    try {
+        (void)(d + d + checked_i128(-1));
+        assert(false); // Should not reach here
+    } catch (const std::overflow_error&) {
+    }
+    try {
+        (void)(d * checked_i128(-2));
+        assert(false); // Should not reach here
+    } catch (const std::overflow_error&) {
+    }
+    try {
+        uint_t<64, overflow_mode::checked> f(bigint("18446744073709551616")); // 2^64
+        assert(false); // Should not reach here
+    } catch (const std::overflow_error&) {
+    }
+    assert(bigint(uint_t<64>(bigint("18446744073709551617"))) == bigint(1));
+
+    // Unsigned arguments are zero-extended, not sign-extended
+    assert(bigint(uint_t<128>(UINT64_MAX)) == bigint("18446744073709551615"));
+    assert(bigint(uint_t<128>(uint64_t(1) << 63)) == bigint("9223372036854775808"));
+    assert(bigint(i128(UINT64_MAX)) == bigint("18446744073709551615"));
+    static_assert(uint_t<128>(UINT64_MAX) != uint_t<128>(-1));
+    static_assert(!std::is_constructible_v<uint_t<128>, bool> && std::is_constructible_v<uint_t<128>, unsigned char>);
+    try {
+        int_t<64, overflow_mode::checked> g(UINT64_MAX);
+        assert(false); // Should not reach here
+    } catch (const std::overflow_error&) {
+    }
+}
+
+void testHashing() {
+    bigint_hash hash;
+    bigint a("-1234567890123456789012345");
+    assert(hash(a) == hash(std::string_view("-1234567890123456789012345")));
+    assert(hash(bigint(-9876543210)) == hash(int64_t(-9876543210)));
+    assert(hash(bigint(0)) == hash(int64_t(0)) && hash(bigint(0)) == hash(std::string_view("0")));
+    assert(hash(a) != hash(-a));
+    assert(std::hash<bigint>()(a) == hash(a));
+
+    std::unordered_map<bigint, int, bigint_hash, bigint_equal> counts;
+    counts[a] = 1;
+    counts[bigint(42)] = 2;
+    counts[bigint(INT64_MIN)] = 3;
+    assert(counts.find(std::string_view("-1234567890123456789012345"))->second == 1);
+    assert(counts.find(int64_t(42))->second == 2);
+    assert(counts.find(INT64_MIN)->second == 3);
+    assert(counts.find(int64_t(-42)) == counts.end());
+    assert(counts.find(std::string_view("042")) == counts.end());
+
+    bigint b = a;
+    b += bigint(1); // changes the digits, so any cached hash is dropped
+    assert(hash(b) == hash(std::string_view("-1234567890123456789012344")));
+}
+
+void testDivision() {
+    bigint a("123456789012345678901234567890");
+    bigint b("-987654321");
+    assert(a / b == bigint("-124999998873437499901"));
+    assert(a % b == bigint("574845669"));
+    assert(-a % b == bigint("-574845669"));
+    assert(a / a == bigint(1) && a % a == bigint(0));
+    assert(bigint(7) / bigint(9) == bigint(0));
+    assert(bigint(-5) / bigint(7) == bigint(0) && (bigint(-5) / bigint(7)).getSign() == 1);
+    try {
+        a /= bigint(0);
+        assert(false); // Should not reach here
+    } catch (const invalid_argument&) {
+    }
+
+    bigint c = a;
+    c.mulPow10(5);
+    assert(c == a * bigint(100000));
+    bigint rem = c.divmodPow10(7);
+    assert(c == bigint("1234567890123456789012345678") && rem == bigint("9000000"));
+
+    // Shifting out every digit leaves a zero quotient
+    bigint d(5);
+    rem = d.divmodPow10(3);
+    assert(d == bigint(0) && rem == bigint(5));
+    bigint e(-120);
+    rem = e.divmodPow10(3);
+    assert(e == bigint(0) && e.getSign() == 1 && rem == bigint(-120));
+}
+
+void testBigdecimal() {
+    bigdecimal a("-12.3400");
+    assert(a.getScale() == 4 && a.getCoefficient() == bigint(-123400));
+    assert(to_string(a) == "-12.3400");
+    assert(to_string(bigdecimal("0.05")) == "0.05");
+    assert(to_string(bigdecimal(bigint(5), -3)) == "5000");
+    assert(bigdecimal("1.5") == bigdecimal("1.50") && bigdecimal("1.49") < bigdecimal("1.5"));
+    assert(bigdecimal("-0.00") == bigdecimal(0) && bigdecimal("0").getScale() == 0);
+    assert(bigdecimal("1.5") <= bigdecimal("1.50") && bigdecimal("1.5") >= bigdecimal("1.50"));
+    assert(bigdecimal("-0.01") < bigdecimal("0") && bigdecimal("2") > bigdecimal("1.999") && !(bigdecimal("1.999") >= bigdecimal("2")));
+    for (string bad : {"", ".", "-", "-.", "1.", ".5", "1.2.3", "1e5", "+1", "007.5", "-00.5"})
+    {
+        try {
+            bigdecimal invalid(bad);
+            assert(false); // Should not reach here
+        } catch (const invalid_argument&) {
+        }
+    }
+
+    bigdecimal sum = bigdecimal("0.1") + bigdecimal("0.02") - bigdecimal("1");
+    assert(to_string(sum) == "-0.88" && sum.getScale() == 2);
+    assert(to_string(bigdecimal("1.5") * bigdecimal("-0.25")) == "-0.375");
+
+    assert(to_string(bigdecimal("2.345").rescale(2, rounding_mode::half_even)) == "2.34");
+    assert(to_string(bigdecimal("2.355").rescale(2, rounding_mode::half_even)) == "2.36");
+    assert(to_string(bigdecimal("-2.345").rescale(2, rounding_mode::half_up)) == "-2.35");
+    assert(to_string(bigdecimal("-2.345").rescale(2, rounding_mode::half_down)) == "-2.34");
+    assert(to_string(bigdecimal("-2.341").rescale(2, rounding_mode::floor)) == "-2.35");
+    assert(to_string(bigdecimal("2.341").rescale(2, rounding_mode::ceiling)) == "2.35");
+    assert(to_string(bigdecimal("2.349").rescale(2, rounding_mode::down)) == "2.34");
+    assert(to_string(bigdecimal("2.3").rescale(4)) == "2.3000");
+    assert(to_string(bigdecimal("0.05").rescale(0)) == "0");
+    assert(to_string(bigdecimal("0.5").rescale(0, rounding_mode::half_up)) == "1");
+    assert(to_string(bigdecimal("-0.5").rescale(0, rounding_mode::half_even)) == "0");
+    assert(to_string(bigdecimal("-0.007").rescale(1, rounding_mode::floor)) == "-0.1");
+    assert(bigdecimal("0.05") < bigdecimal("1") && bigdecimal("0.010") == bigdecimal("0.01"));
+
+    assert(to_string(divide(bigdecimal(1), bigdecimal(3), 5)) == "0.33333");
+    assert(to_string(divide(bigdecimal("-2"), bigdecimal("3"), 3)) == "-0.667");
+    assert(to_string(divide(bigdecimal("10.5"), bigdecimal("0.25"), 0, rounding_mode::down)) == "42");
+    assert(to_string(divide(bigdecimal("1"), bigdecimal("8"), 2, rounding_mode::half_even)) == "0.12");
+}
+
+void testProductTree() {
+    vector<bigint> moduli = {bigint(7), bigint(11), bigint(13), bigint("1000000007"), bigint("998244353")};
+    bigint x("-123456789012345678901234567890");
+    vector<bigint> residues = multi_mod(x, moduli);
+    for (size_t i = 0; i < moduli.size(); i++) {
+        bigint expected = x % moduli[i];
+        if (expected.getSign() == -1)
+            expected += moduli[i];
+        assert(residues[i] == expected);
+    }
+
+    // x mod M is recovered from its residues
+    product_tree tree(moduli);
+    bigint y = x % tree.product() + tree.product();
+    assert(crt_reconstruct(residues, moduli) == y);
+    assert(tree.reduce(y) == residues);
+
+    vector<bigint> single = {bigint(97)};
+    vector<bigint> single_residue = {bigint(5)};
+    assert(crt_reconstruct(single_residue, single) == bigint(5));
+
+    vector<bigint> not_coprime = {bigint(6), bigint(4)};
+    vector<bigint> two_residues = {bigint(1), bigint(1)};
+    try {
+        crt_reconstruct(two_residues, not_coprime);
+        assert(false); // Should not reach here
+    } catch (const invalid_argument&) {
+    }
+}
+
+void testAsync() {
+    string digits;
+    for (size_t i = 0; i < 3000; i++)
+        digits += char('1' + i % 9);
+    bigint a(digits);
+    bigint b("-" + digits.substr(0, 700));
+
+    // shared pool
+    assert(bigint_async::multiply(a, b).get() == a * b);
+    assert(bigint_async::divide(a, b).get() == a / b);
+    assert(bigint_async::divide(b, a).get() == bigint(0));
+
+    // the last block takes every remaining digit, including factors shorter than one block
+    bigint c(digits.substr(0, 128));
+    assert(bigint_async::multiply(c, bigint(-7)).get() == c * bigint(-7));
+    assert(bigint_async::multiply(bigint(5), bigint(3)).get() == bigint(15));
+    assert(bigint_async::divide(c, bigint(9)).get() == c / bigint(9));
+    assert(bigint_async::divide(bigint(-5), bigint(3)).get() == bigint(-1));
+    assert(c.getDigitCount() == 128 && bigint(0).getDigitCount() == 1);
+
+    // caller-supplied executor with progress reports
+    auto inline_executor = [](std::function<void()> task) { task(); };
+    double last = 0;
+    bigint_async::options opts;
+    opts.progress = [&last](double fraction) {
+        assert(fraction >= last);
+        last = fraction;
+    };
+    assert(bigint_async::multiply(a, a, inline_executor, opts).get() == a * a);
+    assert(last == 1.0);
+
+    // cancellation from the progress callback, i.e. midway
+    std::stop_source source;
+    opts.stop = source.get_token();
+    opts.progress = [&source](double fraction) {
+        if (fraction > 0.5)
+            source.request_stop();
+    };
+    auto cancelled = bigint_async::multiply(a, a, inline_executor, opts);
+    try {
+        cancelled.get();
+        assert(false); // Should not reach here
+    } catch (const bigint_async::operation_cancelled&) {
+    }
+
+    // string conversion checks in while converting to binary words
+    assert(bigint_async::to_string(b, 16).get() == to_string(b, 16));
+    assert(bigint_async::to_string(bigint(-255), 2).get() == "-11111111");
+    std::vector<double> fractions;
+    bigint_async::options watched;
+    watched.progress = [&fractions](double fraction) { fractions.push_back(fraction); };
+    assert(bigint_async::to_string(a, 3, inline_executor, watched).get() == to_string(a, 3));
+    assert(fractions.size() > 3 && std::is_sorted(fractions.begin(), fractions.end()) && fractions.back() == 1.0);
+    std::stop_source conversion;
+    watched.stop = conversion.get_token();
+    watched.progress = [&conversion](double fraction) {
+        if (fraction > 0)
+            conversion.request_stop();
+    };
+    try {
+        bigint_async::to_string(a, 3, inline_executor, watched).get();
+        assert(false); // Should not reach here
+    } catch (const bigint_async::operation_cancelled&) {
+    }
+
+    // deadline already passed
+    bigint_async::options late;
+    late.deadline = std::chrono::steady_clock::now() - std::chrono::seconds(1);
+    try {
+        bigint_async::divide(a, b, late).get();
+        assert(false); // Should not reach here
+    } catch (const bigint_async::operation_cancelled&) {
+    }
+
+    try {
+        bigint_async::divide(a, bigint(0)).get();
+        assert(false); // Should not reach here
+    } catch (const invalid_argument&) {
+    }
+
+    // tasks still queued when the pool shuts down, or dropped by an executor, are cancelled
+    std::future<bigint> queued;
+    {
+        bigint_async::thread_pool idle(0);
+        queued = bigint_async::multiply(a, b, idle);
+    }
+    try {
+        queued.get();
+        assert(false); // Should not reach here
+    } catch (const bigint_async::operation_cancelled&) {
+    }
+    auto dropping_executor = [](std::function<void()>) {};
+    try {
+        bigint_async::divide(a, b, dropping_executor).get();
+        assert(false); // Should not reach here
+    } catch (const bigint_async::operation_cancelled&) {
+    }
+}
+
 int main()
 {
     /* separate functions */ 
     testAddition();
     testAssignment();
+    testCopiesAreIndependent();
+    testMovedFrom();
     testComparison();
     testDefaultConstructor();
     testEquality();
     testIntegerConstructor();
     testInvalidString();
     testLargeNumbers();
+    testLongOperands();
+    testSignOfValuesEndingInZero();
+    testLongComparison();
     testLeadingZeros();
     testMultiplication();
     testNegation();
     testStringConstructor();
+    testToChars();
+    testFormatSpec();
+    testLazyExpressions();
+    testStaticBigint();
+    testFixedInt();
+    testHashing();
+    testDivision();
+    testBigdecimal();
+    testProductTree();
+    testAsync();
     /* combination */
     /* A, B, C, D: constructors */
     bigint A;           // default (0) constructor
@@ -0,0 +1,388 @@
+/**
+ * @file fixed_int.hpp
+ * @author {Eva Wu} ({gudautd@gmail.com})
+ * @brief Header file and implementation of fixed-width integer class template 'fixed_int'
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+#pragma once
+#include <array>
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include "bigint.hpp"
+
+/** @brief Behaviour of fixed_int when a result does not fit in its width. */
+enum class overflow_mode
+{
+    wrap,   ///< Results are reduced modulo 2^Bits, like built-in unsigned integers.
+    checked ///< Results that do not fit throw std::overflow_error.
+};
+
+/**
+ * @brief Integer of a fixed width stored inline as 64-bit limbs in two's complement.
+ * Limb loops are unrolled at compile time and no operation allocates.
+ * @tparam Bits Width in bits, a positive multiple of 64.
+ * @tparam Signed Whether the value is signed.
+ * @tparam Mode What to do when a result does not fit.
+ */
+template <size_t Bits, bool Signed, overflow_mode Mode = overflow_mode::wrap>
+class fixed_int
+{
+    static_assert(Bits > 0 && Bits % 64 == 0, "fixed_int width should be a positive multiple of 64");
+
+public:
+    /** @brief Number of 64-bit limbs. */
+    static constexpr size_t limb_count = Bits / 64;
+
+private:
+    /** @brief Limbs of the two's complement representation, least significant first. */
+    std::array<uint64_t, limb_count> limbs{};
+
+#ifdef __SIZEOF_INT128__
+    /** @brief Double-limb type for products and divisions; __extension__ keeps -Wpedantic quiet about it. */
+    __extension__ typedef unsigned __int128 u128;
+#endif
+
+    /** @brief Calls f(0), f(1), ..., f(limb_count - 1) as straight-line code. */
+    template <typename F, size_t... I>
+    static constexpr void unrollImpl(F &&f, std::index_sequence<I...>)
+    {
+        (f(I), ...);
+    }
+
+    template <typename F>
+    static constexpr void unroll(F &&f)
+    {
+        unrollImpl(f, std::make_index_sequence<limb_count>());
+    }
+
+    /** @brief Multiplies two limbs into a 128-bit result.
+     *  @param a The first factor.
+     *  @param b The second factor.
+     *  @param high Receives the upper 64 bits.
+     *  @return The lower 64 bits.
+     */
+    static constexpr uint64_t mulWide(uint64_t a, uint64_t b, uint64_t &high)
+    {
+#ifdef __SIZEOF_INT128__
+        u128 product = u128(a) * b;
+        high = uint64_t(product >> 64);
+        return uint64_t(product);
+#else
+        // Schoolbook on 32-bit halves
+        uint64_t a_lo = a & 0xffffffff, a_hi = a >> 32;
+        uint64_t b_lo = b & 0xffffffff, b_hi = b >> 32;
+        uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+        uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+        high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+        return (cross << 32) | (lo_lo & 0xffffffff);
+#endif
+    }
+
+    /** @brief Whether the two's complement sign bit is set (always false for unsigned). */
+    constexpr bool isNegative() const
+    {
+        return Signed && (limbs[limb_count - 1] >> 63);
+    }
+
+    /** @brief Two's complement negation of the limbs, ignoring overflow. */
+    constexpr void negateLimbs()
+    {
+        uint64_t carry = 1;
+        unroll([&](size_t i) {
+            limbs[i] = ~limbs[i] + carry;
+            carry = (carry && limbs[i] == 0);
+        });
+    }
+
+    /** @brief Exception for results that do not fit in checked mode. */
+    static void overflow()
+    {
+        throw std::overflow_error("Result does not fit in fixed_int!");
+    }
+
+public:
+    /** @brief Constructs a fixed_int initialized to zero. */
+    constexpr fixed_int() = default;
+
+    /** @brief Constructs a fixed_int from an int64_t, sign-extending it.
+     *  @param number The int64_t value to initialize from.
+     */
+    constexpr fixed_int(int64_t number)
+    {
+        if constexpr (Mode == overflow_mode::checked && !Signed)
+            if (number < 0)
+                overflow();
+        limbs.fill(number < 0 ? ~uint64_t(0) : 0);
+        limbs[0] = uint64_t(number);
+    }
+
+    /** @brief Constructs a fixed_int from an unsigned integer, zero-extending it.
+     *  @param number The unsigned value to initialize from.
+     */
+    template <std::unsigned_integral T>
+        requires(!std::same_as<T, bool>)
+    constexpr fixed_int(T number)
+    {
+        if constexpr (Mode == overflow_mode::checked && Signed && limb_count == 1)
+            if (uint64_t(number) >> 63)
+                overflow();
+        limbs[0] = uint64_t(number);
+    }
+
+    /** @brief Construction from bool is rejected rather than read as 0 or 1. */
+    template <std::same_as<bool> T>
+    fixed_int(T) = delete;
+
+    /** @brief Constructs a fixed_int from a bigint. In wrap mode the value is reduced modulo 2^Bits.
+     *  @param value The bigint to convert from.
+     */
+    explicit fixed_int(const bigint &value)
+    {
+        // Hexadecimal output is read straight off the binary words, four bits per character
+        string hex = to_string(value, 16);
+        bool negative = (hex[0] == '-');
+        size_t first = negative ? 1 : 0;
+        bool truncated = false;
+        for (size_t i = hex.size(), bit = 0; i > first; i--, bit += 4)
+        {
+            char ch = hex[i - 1];
+            uint64_t nibble = uint64_t((ch <= '9') ? ch - '0' : ch - 'a' + 10);
+            if (bit < Bits)
+                limbs[bit / 64] |= nibble << (bit % 64);
+            else
+                truncated = truncated || nibble;
+        }
+        if constexpr (Mode == overflow_mode::checked)
+        {
+            // The magnitude must fit, and for signed values stay within [-2^(Bits-1), 2^(Bits-1) - 1]
+            bool top = (limbs[limb_count - 1] >> 63);
+            bool fits = !truncated && (Signed ? (!top || (negative && isMinMagnitude())) : !negative);
+            if (!fits)
+                overflow();
+        }
+        if (negative)
+            negateLimbs();
+    }
+
+    /** @brief Converts to a bigint.
+     *  @return The equivalent bigint.
+     */
+    explicit operator bigint() const
+    {
+        fixed_int magnitude = *this;
+        bool negative = isNegative();
+        if (negative)
+            magnitude.negateLimbs();
+
+        // Peel off 19 decimal digits at a time by short division of the limbs
+        constexpr uint64_t chunk_base = 10000000000000000000ull;
+        std::array<uint64_t, limb_count> rest = magnitude.limbs;
+        string reversed;
+        bool nonzero = true;
+        while (nonzero)
+        {
+            uint64_t rem = 0;
+            nonzero = false;
+            for (size_t i = limb_count; i > 0; i--)
+            {
+#ifdef __SIZEOF_INT128__
+                u128 cur = (u128(rem) << 64) | rest[i - 1];
+                rest[i - 1] = uint64_t(cur / chunk_base);
+                rem = uint64_t(cur % chunk_base);
+#else
+                // Bit-serial long division when no 128-bit type is available
+                uint64_t quotient = 0;
+                for (int b = 63; b >= 0; b--)
+                {
+                    bool high = rem >> 63;
+                    rem = (rem << 1) | ((rest[i - 1] >> b) & 1);
+                    quotient <<= 1;
+                    if (high || rem >= chunk_base)
+                    {
+                        rem -= chunk_base;
+                        quotient |= 1;
+                    }
+                }
+                rest[i - 1] = quotient;
+#endif
+                nonzero = nonzero || rest[i - 1];
+            }
+            for (size_t k = 0; k < 19 && (rem || nonzero); k++, rem /= 10)
+                reversed.push_back(char('0' + rem % 10));
+        }
+        if (reversed.empty())
+            return bigint();
+        if (negative)
+            reversed.push_back('-');
+        return bigint(string(reversed.rbegin(), reversed.rend()));
+    }
+
+    /** @brief Gets the limbs of the two's complement representation.
+     *  @return Array of limbs, least significant first.
+     */
+    constexpr const std::array<uint64_t, limb_count> &getLimbs() const
+    {
+        return limbs;
+    }
+
+    /** @brief Adds a fixed_int to the current one. */
+    constexpr fixed_int &operator+=(const fixed_int &rhs)
+    {
+        bool lhs_negative = isNegative();
+        uint64_t carry = 0;
+        unroll([&](size_t i) {
+            uint64_t sum = limbs[i] + rhs.limbs[i];
+            uint64_t carry_new = (sum < limbs[i]);
+            limbs[i] = sum + carry;
+            carry = carry_new | (limbs[i] < sum);
+        });
+        if constexpr (Mode == overflow_mode::checked)
+        {
+            // Unsigned: carry out of the top limb. Signed: operands of equal sign giving the other sign.
+            bool overflowed = Signed ? (lhs_negative == rhs.isNegative() && isNegative() != lhs_negative) : carry;
+            if (overflowed)
+                overflow();
+        }
+        return *this;
+    }
+
+    /** @brief Subtracts a fixed_int from the current one. */
+    constexpr fixed_int &operator-=(const fixed_int &rhs)
+    {
+        bool lhs_negative = isNegative();
+        uint64_t borrow = 0;
+        unroll([&](size_t i) {
+            uint64_t diff = limbs[i] - rhs.limbs[i];
+            uint64_t borrow_new = (diff > limbs[i]);
+            limbs[i] = diff - borrow;
+            borrow = borrow_new | (limbs[i] > diff);
+        });
+        if constexpr (Mode == overflow_mode::checked)
+        {
+            // Unsigned: borrow out of the top limb. Signed: operands of different sign giving the sign of rhs.
+            bool overflowed = Signed ? (lhs_negative != rhs.isNegative() && isNegative() != lhs_negative) : borrow;
+            if (overflowed)
+                overflow();
+        }
+        return *this;
+    }
+
+    /** @brief Multiplies the current fixed_int with another one. */
+    constexpr fixed_int &operator*=(const fixed_int &rhs)
+    {
+        if constexpr (Mode == overflow_mode::wrap)
+        {
+            // Two's complement makes the low Bits of the product independent of the signs;
+            // only partial products landing below limb_count are needed.
+            std::array<uint64_t, limb_count> result{};
+            unroll([&](size_t i) {
+                uint64_t carry = 0;
+                unroll([&](size_t j) {
+                    if (i + j >= limb_count)
+                        return;
+                    uint64_t high;
+                    uint64_t low = mulWide(limbs[i], rhs.limbs[j], high);
+                    uint64_t sum = result[i + j] + low;
+                    high += (sum < low);
+                    result[i + j] = sum + carry;
+                    carry = high + (result[i + j] < sum);
+                });
+            });
+            limbs = result;
+        }
+        else
+        {
+            // Multiply the magnitudes into the full double width and check the upper half.
+            fixed_int lhs_mag = *this, rhs_mag = rhs;
+            bool negative = isNegative() != rhs.isNegative();
+            if (isNegative())
+                lhs_mag.negateLimbs();
+            if (rhs.isNegative())
+                rhs_mag.negateLimbs();
+            std::array<uint64_t, 2 * limb_count> result{};
+            unroll([&](size_t i) {
+                uint64_t carry = 0;
+                unroll([&](size_t j) {
+                    uint64_t high;
+                    uint64_t low = mulWide(lhs_mag.limbs[i], rhs_mag.limbs[j], high);
+                    uint64_t sum = result[i + j] + low;
+                    high += (sum < low);
+                    result[i + j] = sum + carry;
+                    carry = high + (result[i + j] < sum);
+                });
+                result[i + limb_count] = carry;
+            });
+            bool truncated = false;
+            unroll([&](size_t i) {
+                limbs[i] = result[i];
+                truncated = truncated || result[i + limb_count];
+            });
+            bool top = (limbs[limb_count - 1] >> 63);
+            if (truncated || (Signed && top && !(negative && isMinMagnitude())))
+                overflow();
+            if (negative)
+                negateLimbs();
+        }
+        return *this;
+    }
+
+    /** @brief Negates a fixed_int. In wrap mode this is the two's complement negation. */
+    constexpr fixed_int operator-() const
+    {
+        if constexpr (Mode == overflow_mode::checked)
+            if (Signed ? isMinMagnitude() : !isZero())
+                overflow();
+        fixed_int result = *this;
+        result.negateLimbs();
+        return result;
+    }
+
+    constexpr fixed_int operator+(const fixed_int &rhs) const { return fixed_int(*this) += rhs; }
+    constexpr fixed_int operator-(const fixed_int &rhs) const { return fixed_int(*this) -= rhs; }
+    constexpr fixed_int operator*(const fixed_int &rhs) const { return fixed_int(*this) *= rhs; }
+
+    friend constexpr bool operator==(const fixed_int &lhs, const fixed_int &rhs) = default;
+
+    friend constexpr std::strong_ordering operator<=>(const fixed_int &lhs, const fixed_int &rhs)
+    {
+        // Signed values of different sign order by sign; otherwise compare limbs as unsigned from the top.
+        if (lhs.isNegative() != rhs.isNegative())
+            return lhs.isNegative() ? std::strong_ordering::less : std::strong_ordering::greater;
+        for (size_t i = limb_count; i > 0; i--)
+            if (lhs.limbs[i - 1] != rhs.limbs[i - 1])
+                return lhs.limbs[i - 1] <=> rhs.limbs[i - 1];
+        return std::strong_ordering::equal;
+    }
+
+private:
+    constexpr bool isZero() const
+    {
+        bool zero = true;
+        unroll([&](size_t i) { zero = zero && !limbs[i]; });
+        return zero;
+    }
+
+    /** @brief Whether the limbs hold exactly 2^(Bits-1), the magnitude of the most negative signed value. */
+    constexpr bool isMinMagnitude() const
+    {
+        bool min = (limbs[limb_count - 1] == (uint64_t(1) << 63));
+        for (size_t i = 0; i + 1 < limb_count; i++)
+            min = min && !limbs[i];
+        return min;
+    }
+};
+
+/** @brief Unsigned fixed-width integer of Bits bits. */
+template <size_t Bits, overflow_mode Mode = overflow_mode::wrap>
+using uint_t = fixed_int<Bits, false, Mode>;
+
+/** @brief Signed fixed-width integer of Bits bits. */
+template <size_t Bits, overflow_mode Mode = overflow_mode::wrap>
+using int_t = fixed_int<Bits, true, Mode>;
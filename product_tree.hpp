@@ -0,0 +1,234 @@
+/**
+ * @file product_tree.hpp
+ * @author {Eva Wu} ({gudautd@gmail.com})
+ * @brief Header file and implementation of class 'product_tree', batch reduction and CRT reconstruction for bigint
+ * @version 0.1
+ * @date 2026-10-18
+ * 
+ * @copyright Copyright (c) 2023
+ * 
+ */
+#pragma once
+#include <future>
+#include <span>
+#include <thread>
+#include <vector>
+#include "bigint.hpp"
+
+/**
+ * @brief Binary tree of products over a list of moduli.
+ * Level 0 holds the moduli, every node above holds the product of its two children (an odd node is
+ * carried up unchanged), and the root holds the product of all moduli. Reducing a value modulo every
+ * modulus then walks the remainders down the tree instead of dividing the full value k times.
+ * Nodes of one level are independent and are computed in parallel. With Karatsuba multiplication and
+ * recursive division in bigint, building and walking the tree is subquadratic in the total number of digits.
+ */
+class product_tree
+{
+private:
+    /** @brief Levels of the tree, from the moduli (level 0) up to the root. */
+    vector<vector<bigint>> levels;
+
+    /** @brief Exception for an empty list of moduli or a non-positive modulus. */
+    inline static invalid_argument invalid_moduli = invalid_argument("Moduli should be a non-empty list of positive numbers!");
+
+    /** @brief Calls f(i) for i in [0, count), split into contiguous chunks over the available hardware threads.
+     *  @param count Number of independent tasks.
+     *  @param f The task.
+     */
+    template <typename F>
+    static void parallelFor(size_t count, const F &f);
+
+public:
+    /** @brief Builds the product tree of a list of positive moduli.
+     *  @param moduli The moduli, all positive.
+     */
+    product_tree(std::span<const bigint> moduli);
+
+    /** @brief Gets the product of all moduli.
+     *  @return The root of the tree.
+     */
+    const bigint &product() const;
+
+    /** @brief Gets the levels of the tree.
+     *  @return Vector of levels, from the moduli (level 0) up to the root.
+     */
+    const vector<vector<bigint>> &getLevels() const;
+
+    /** @brief Reduces a value modulo every modulus through the remainder tree.
+     *  @param x The value to reduce, may be negative.
+     *  @return The residues x mod m_i, each in [0, m_i), in the order of the moduli.
+     */
+    vector<bigint> reduce(const bigint &x) const;
+
+    friend bigint crt_reconstruct(std::span<const bigint> residues, std::span<const bigint> moduli);
+};
+
+/**
+ * @brief Reduces a value modulo many moduli at once using a product tree and a remainder tree.
+ * @param x The value to reduce, may be negative.
+ * @param moduli The moduli, all positive.
+ * @return The residues x mod m_i, each in [0, m_i), in the order of the moduli.
+ */
+vector<bigint> multi_mod(const bigint &x, std::span<const bigint> moduli);
+
+/**
+ * @brief Reconstructs the value with the given residues modulo pairwise coprime moduli (Chinese remainder theorem).
+ * @param residues The residues, one per modulus.
+ * @param moduli The moduli, positive and pairwise coprime.
+ * @return The unique value in [0, m_1 * ... * m_k) with the given residues.
+ */
+bigint crt_reconstruct(std::span<const bigint> residues, std::span<const bigint> moduli);
+
+
+/** implementation starts **/
+
+
+template <typename F>
+void product_tree::parallelFor(size_t count, const F &f)
+{
+    size_t threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    size_t chunks = std::min(threads, count);
+    if (chunks <= 1)
+    {
+        for (size_t i = 0; i < count; i++)
+            f(i);
+        return;
+    }
+    // The calling thread takes the first chunk, the others run asynchronously
+    vector<std::future<void>> pending;
+    size_t chunk_len = (count + chunks - 1) / chunks;
+    for (size_t begin = chunk_len; begin < count; begin += chunk_len)
+    {
+        size_t end = std::min(count, begin + chunk_len);
+        pending.push_back(std::async(std::launch::async, [&f, begin, end] {
+            for (size_t i = begin; i < end; i++)
+                f(i);
+        }));
+    }
+    for (size_t i = 0; i < chunk_len; i++)
+        f(i);
+    for (std::future<void> &task : pending)
+        task.get(); // rethrows exceptions of the task
+}
+
+
+product_tree::product_tree(std::span<const bigint> moduli)
+{
+    if (moduli.empty())
+        throw invalid_moduli;
+    for (const bigint &modulus : moduli)
+        if (modulus <= bigint(0))
+            throw invalid_moduli;
+
+    levels.emplace_back(moduli.begin(), moduli.end());
+    while (levels.back().size() > 1)
+    {
+        const vector<bigint> &below = levels.back();
+        vector<bigint> above((below.size() + 1) / 2);
+        parallelFor(above.size(), [&](size_t i) {
+            // An odd node at the end is carried up unchanged
+            above[i] = (2 * i + 1 < below.size()) ? below[2 * i] * below[2 * i + 1] : below[2 * i];
+        });
+        levels.push_back(std::move(above));
+    }
+}
+
+
+const bigint &product_tree::product() const
+{
+    return levels.back()[0];
+}
+
+
+const vector<vector<bigint>> &product_tree::getLevels() const
+{
+    return levels;
+}
+
+
+vector<bigint> product_tree::reduce(const bigint &x) const
+{
+    // Reduce modulo the root first, adjusting a negative remainder so every residue is non-negative
+    vector<bigint> remainders = {x % product()};
+    if (remainders[0].getSign() == -1)
+        remainders[0] += product();
+
+    // Walk down: a node's remainder is its parent's remainder reduced by the node, which is much smaller than x
+    for (size_t k = levels.size() - 1; k > 0; k--)
+    {
+        const vector<bigint> &below = levels[k - 1];
+        vector<bigint> next(below.size());
+        parallelFor(below.size(), [&](size_t i) {
+            next[i] = remainders[i / 2] % below[i];
+        });
+        remainders = std::move(next);
+    }
+    return remainders;
+}
+
+
+vector<bigint> multi_mod(const bigint &x, std::span<const bigint> moduli)
+{
+    return product_tree(moduli).reduce(x);
+}
+
+
+bigint crt_reconstruct(std::span<const bigint> residues, std::span<const bigint> moduli)
+{
+    if (residues.size() != moduli.size())
+        throw invalid_argument("There should be one residue per modulus!");
+    product_tree tree(moduli);
+    const vector<vector<bigint>> &levels = tree.getLevels();
+    const bigint &total = tree.product();
+    size_t count = moduli.size();
+
+    // (M / m_i) mod m_i is (M mod m_i^2) / m_i, so one remainder tree over the squares gives all of them
+    vector<bigint> squares(count);
+    for (size_t i = 0; i < count; i++)
+        squares[i] = moduli[i] * moduli[i];
+    vector<bigint> cofactors = multi_mod(total, squares);
+
+    // c_i = r_i * ((M / m_i) mod m_i)^-1 mod m_i, with the inverse from the extended Euclidean algorithm;
+    // each inversion is quadratic in the length of its modulus, so they run in parallel
+    vector<bigint> terms(count);
+    product_tree::parallelFor(count, [&](size_t i) {
+        const bigint &modulus = moduli[i];
+        bigint old_r = cofactors[i] / modulus;
+        bigint r = modulus;
+        bigint old_s(1);
+        bigint s(0);
+        while (r != bigint(0))
+        {
+            bigint q = old_r;
+            bigint next_r = q.divmod(r);
+            old_r = r;
+            r = next_r;
+            bigint next_s = old_s - q * s;
+            old_s = s;
+            s = next_s;
+        }
+        if (old_r != bigint(1))
+            throw invalid_argument("Moduli should be pairwise coprime!");
+        bigint term = (residues[i] % modulus) * old_s % modulus;
+        if (term.getSign() == -1)
+            term += modulus;
+        terms[i] = term;
+    });
+
+    // Combine up the product tree: a node's value is value_left * product_right + value_right * product_left,
+    // which equals sum of c_i * (M_node / m_i) over the moduli below the node
+    for (size_t k = 0; k + 1 < levels.size(); k++)
+    {
+        const vector<bigint> &products = levels[k];
+        vector<bigint> above(levels[k + 1].size());
+        product_tree::parallelFor(above.size(), [&](size_t i) {
+            if (2 * i + 1 < products.size())
+                above[i] = terms[2 * i] * products[2 * i + 1] + terms[2 * i + 1] * products[2 * i];
+            else
+                above[i] = terms[2 * i];
+        });
+        terms = std::move(above);
+    }
+    return terms[0] % total;
+}